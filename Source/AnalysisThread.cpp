@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    Off-audio-thread analysis of the wet output.
+
+  ==============================================================================
+*/
+
+#include "AnalysisThread.h"
+
+namespace webview_plugin
+{
+    void AnalysisRing::push(juce::dsp::AudioBlock<const float> block) noexcept
+    {
+        const auto numSamples = static_cast<int>(block.getNumSamples());
+        const auto lastChannel = block.getNumChannels() - 1;
+        const auto scope = fifo.write(numSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* source = block.getChannelPointer(juce::jmin((size_t)ch, lastChannel));
+
+            if (scope.blockSize1 > 0)
+                buffer.copyFrom(ch, scope.startIndex1, source, scope.blockSize1);
+            if (scope.blockSize2 > 0)
+                buffer.copyFrom(ch, scope.startIndex2, source + scope.blockSize1, scope.blockSize2);
+        }
+    }
+
+    int AnalysisRing::pop(float* const* destination, int maxSamples) noexcept
+    {
+        const auto scope = fifo.read(juce::jmin(maxSamples, fifo.getNumReady()));
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (scope.blockSize1 > 0)
+                juce::FloatVectorOperations::copy(destination[ch], buffer.getReadPointer(ch, scope.startIndex1), scope.blockSize1);
+            if (scope.blockSize2 > 0)
+                juce::FloatVectorOperations::copy(destination[ch] + scope.blockSize1, buffer.getReadPointer(ch, scope.startIndex2), scope.blockSize2);
+        }
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    AnalysisThread::AnalysisThread()
+        : juce::Thread("3DVerb analysis")
+    {
+    }
+
+    AnalysisThread::~AnalysisThread()
+    {
+        stopThread(1000);
+    }
+
+    void AnalysisThread::prepare(double sampleRate)
+    {
+        jassert(!isThreadRunning());
+
+        currentSampleRate = sampleRate;
+        ring.reset();
+        loudnessMeter.prepare(sampleRate);
+        outputEnvelope = 0.0f;
+        outputLevelDecibels = LoudnessMeter::silenceDecibels;
+    }
+
+    void AnalysisThread::setFftOrder(int order) noexcept
+    {
+        switch (order)
+        {
+            case 10: currentSpectrum = &smallSpectrum; break;
+            case 12: currentSpectrum = &largeSpectrum; break;
+            default: currentSpectrum = &mediumSpectrum; break;
+        }
+    }
+
+    void AnalysisThread::setFftOverlap(int overlap) noexcept
+    {
+        smallSpectrum.overlap = overlap;
+        mediumSpectrum.overlap = overlap;
+        largeSpectrum.overlap = overlap;
+    }
+
+    void AnalysisThread::run()
+    {
+        while (!threadShouldExit())
+        {
+            const auto numSamples = ring.pop(chunk.getArrayOfWritePointers(), chunkSize);
+
+            // the audio thread never signals us (that could block it); poll instead
+            if (numSamples == 0)
+            {
+                wait(5);
+                continue;
+            }
+
+            analyse(numSamples);
+        }
+    }
+
+    void AnalysisThread::analysePending() noexcept
+    {
+        jassert(!isThreadRunning());
+
+        for (auto numSamples = ring.pop(chunk.getArrayOfWritePointers(), chunkSize); numSamples > 0;
+             numSamples = ring.pop(chunk.getArrayOfWritePointers(), chunkSize))
+            analyse(numSamples);
+    }
+
+    void AnalysisThread::analyse(int numSamples)
+    {
+        TDV_TRACE_SCOPE("AnalysisThread::analyse");
+
+        const auto* left = chunk.getReadPointer(0);
+        const auto* right = chunk.getReadPointer(1);
+
+        // average L + R stereo samples into single sample
+        // push samples into an array so that a set block of samples
+        // can be processed by FFT algorithm. FFT transforms time domain to frequency domain.
+        juce::FloatVectorOperations::add(monoChunk.data(), left, right, numSamples);
+        juce::FloatVectorOperations::multiply(monoChunk.data(), 0.5f, numSamples);
+        currentSpectrum.load()->push(monoChunk.data(), numSamples);
+
+        loudnessMeter.process(chunk.getArrayOfReadPointers(), numSamples);
+
+        const auto range = juce::FloatVectorOperations::findMinAndMax(left, numSamples);
+        const auto peak = juce::jmax(std::abs(range.getStart()), std::abs(range.getEnd()));
+        const auto release = static_cast<float>(std::exp(-numSamples / (outputLevelReleaseSeconds * currentSampleRate)));
+
+        outputEnvelope = peak > outputEnvelope ? peak : peak + (outputEnvelope - peak) * release;
+        outputLevelDecibels.store(juce::Decibels::gainToDecibels(outputEnvelope), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    Moves output analysis (FFT levels, loudness, true peak, output level)
+    off the audio thread.
+
+    processBlock() only copies the wet output into a lock-free ring;
+    the analysis thread drains it and feeds the selected Fifo and LoudnessMeter.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Fifo.h"
+#include "LoudnessMeter.h"
+
+namespace webview_plugin
+{
+    // single producer (audio thread) / single consumer (analysis thread) ring of stereo samples
+    class AnalysisRing
+    {
+    public:
+        static constexpr auto numChannels{ 2 };
+        static constexpr auto capacity{ 1 << 15 };
+
+        // audio thread; a mono block is written to both channels
+        // if the analysis thread has fallen behind, the samples that don't fit are dropped
+        void push(juce::dsp::AudioBlock<const float> block) noexcept;
+        // analysis thread; returns the number of samples copied to each destination channel
+        int pop(float* const* destination, int maxSamples) noexcept;
+        // only while neither thread is running
+        void reset() noexcept { fifo.reset(); }
+
+    private:
+        juce::AbstractFifo fifo{ capacity };
+        juce::AudioBuffer<float> buffer{ numChannels, capacity };
+    };
+
+    class AnalysisThread : public juce::Thread
+    {
+    public:
+        AnalysisThread();
+        ~AnalysisThread() override;
+
+        // call while stopped (from prepareToPlay)
+        void prepare(double sampleRate);
+
+        // audio thread
+        void push(juce::dsp::AudioBlock<const float> block) noexcept { ring.push(block); }
+
+        void run() override;
+
+        // only while the thread is stopped (offline tools such as the fingerprint check): analyses
+        // everything pushed so far on the calling thread, so the results don't depend on scheduling.
+        // Call after every block; the ring drops what doesn't fit
+        void analysePending() noexcept;
+
+        // 10, 11 or 12 (1024, 2048 or 4096 point FFT); any thread
+        void setFftOrder(int order) noexcept;
+        // 1, 2 or 4; applies to every analysis size
+        void setFftOverlap(int overlap) noexcept;
+        // the editor locks levelsLock on whichever analyser this returns
+        SpectrumAnalyser& getSpectrum() noexcept { return *currentSpectrum.load(); }
+
+        float getOutputLevelDecibels() const noexcept { return outputLevelDecibels.load(std::memory_order_relaxed); }
+        const LoudnessMeter& getLoudnessMeter() const noexcept { return loudnessMeter; }
+
+    private:
+        void analyse(int numSamples);
+
+        static constexpr auto chunkSize{ 1024 };
+        // output level: instant attack, 200 ms release (replaces the audio thread's BallisticsFilter)
+        static constexpr auto outputLevelReleaseSeconds{ 0.2 };
+
+        // one instantiation per selectable size; switching is just a pointer swap
+        Fifo<10> smallSpectrum;
+        Fifo<11> mediumSpectrum;
+        Fifo<12> largeSpectrum;
+        std::atomic<SpectrumAnalyser*> currentSpectrum{ &mediumSpectrum };
+
+        AnalysisRing ring;
+        LoudnessMeter loudnessMeter;
+
+        juce::AudioBuffer<float> chunk{ AnalysisRing::numChannels, chunkSize };
+        std::array<float, chunkSize> monoChunk{};
+        double currentSampleRate{ 44100.0 };
+        float outputEnvelope{ 0.0f };
+        std::atomic<float> outputLevelDecibels{ LoudnessMeter::silenceDecibels };
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisThread)
+    };
+}
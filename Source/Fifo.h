@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    FFT analysis of the wet output for the frontend's particle wave.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Tracing.h"
+
+namespace webview_plugin
+{
+    namespace detail
+    {
+        // cos() via a Chebyshev recurrence so whole tables can be built at compile time
+        // (std::cos is not constexpr in C++17); only cos(step) needs a Taylor series
+        constexpr double taylorCos(double x) noexcept
+        {
+            auto term{ 1.0 };
+            auto sum{ 1.0 };
+            for (int n = 1; n < 24; ++n)
+            {
+                term *= -x * x / ((2.0 * n - 1.0) * (2.0 * n));
+                sum += term;
+            }
+            return sum;
+        }
+
+        // matches juce::dsp::WindowingFunction<float>::hann with normalise = true
+        template <int size>
+        constexpr std::array<float, size> makeHannWindow() noexcept
+        {
+            std::array<double, size> window{};
+            const auto cosStep = taylorCos(2.0 * juce::MathConstants<double>::pi / (size - 1));
+            auto cosPrevious = cosStep; // cos(-step)
+            auto cosCurrent = 1.0;      // cos(0)
+            auto sum{ 0.0 };
+
+            for (int i = 0; i < size; ++i)
+            {
+                window[(size_t)i] = 0.5 - 0.5 * cosCurrent;
+                sum += window[(size_t)i];
+
+                const auto cosNext = 2.0 * cosStep * cosCurrent - cosPrevious;
+                cosPrevious = cosCurrent;
+                cosCurrent = cosNext;
+            }
+
+            std::array<float, size> normalised{};
+            for (int i = 0; i < size; ++i)
+                normalised[(size_t)i] = static_cast<float>(window[(size_t)i] * size / sum);
+
+            return normalised;
+        }
+
+        // y such that y^5 == x, for 0 < x <= 1 (Newton's method)
+        constexpr double fifthRoot(double x) noexcept
+        {
+            auto y{ 1.0 };
+            for (int i = 0; i < 40; ++i)
+            {
+                const auto y4 = y * y * y * y;
+                y -= (y4 * y - x) / (5.0 * y4);
+            }
+            return y;
+        }
+
+        // FFT bin shown at each scope position: log-like skew 1 - (1 - i / scopeSize)^0.2
+        template <int fftSize, int scopeSize>
+        constexpr std::array<int, scopeSize> makeBandTable() noexcept
+        {
+            std::array<int, scopeSize> bands{};
+            for (int i = 0; i < scopeSize; ++i)
+            {
+                const auto skewedProportionX = 1.0 - fifthRoot(1.0 - (double)i / (double)scopeSize);
+                const auto fftDataIndex = (int)(skewedProportionX * fftSize * 0.5);
+                bands[(size_t)i] = fftDataIndex < 0 ? 0 : (fftDataIndex > fftSize / 2 ? fftSize / 2 : fftDataIndex);
+            }
+            return bands;
+        }
+    }
+
+    // what the editor reads, whatever the analysis size
+    struct SpectrumAnalyser
+    {
+        virtual ~SpectrumAnalyser() = default;
+
+        // analysis thread
+        virtual void push(const float* monoSamples, int numSamples) noexcept = 0;
+        virtual int getScopeSize() const noexcept = 0;
+
+        // 1 = back-to-back FFT frames; 2 or 4 = frames overlap by 1/2 or 3/4 (more frequent updates)
+        std::atomic<int> overlap{ 1 };
+
+        // store normalized levels derived from fftData using applyLogarithmicFreqMapping() below
+        juce::Array<juce::var> levels;
+        juce::SpinLock levelsLock;
+    };
+
+    // FFT order and scope size are template parameters so the window and band tables
+    // are built at compile time and every loop below has a constant trip count
+    template <int order, int numScopeBins = (1 << order) / 4>
+    struct Fifo : SpectrumAnalyser
+    {
+        static constexpr auto fftOrder{ order };
+        static constexpr auto fftSize{ 1 << fftOrder };
+        static constexpr auto fftDataSize{ fftSize * 2 };
+        static constexpr auto scopeSize{ numScopeBins };
+
+        static constexpr auto windowTable{ detail::makeHannWindow<fftSize>() };
+        static constexpr auto bandTable{ detail::makeBandTable<fftSize, scopeSize>() };
+
+        juce::dsp::FFT forwardFFT{ fftOrder };
+        std::array<float, fftSize> samples;
+        // for holding FFT processed sample data; FFT algorithm requires double space
+        std::array<float, fftDataSize> fftSampleData; 
+        int index{ 0 };
+
+        int getScopeSize() const noexcept override { return scopeSize; }
+
+        void push(const float* monoSamples, int numSamples) noexcept override
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                push(monoSamples[i]);
+            }
+        }
+
+        // processSubBlock() -> AnalysisThread::push() -> AnalysisRing -> AnalysisThread::run() -> analyse() -> push()
+        // PluginEditor.cpp in getResource() -> const juce::SpinLock::ScopedLockType lock(audioProcessor.levelsLock)
+        // occasionally front end will hold  the lock first since JSON serialization can take microseconds or more
+        void push(float sample) noexcept
+        {
+            if (index == fftSize)
+            {
+                TDV_TRACE_SCOPE("Fifo::push FFT");
+                // copy fifo sample data into beginning of fftSampleData
+                // for intermediate calcs, fftSampleData can hold twice as much data as fifo
+                std::copy(samples.begin(), samples.end(), fftSampleData.begin());
+                // reduce spectral leakage by applying windowing function to data; make more perceptually accurate
+                juce::FloatVectorOperations::multiply(fftSampleData.data(), windowTable.data(), fftSize);
+                // perform FFT on fftData; only keep frequency information; only calculate non-negative frequencies;
+                forwardFFT.performFrequencyOnlyForwardTransform(fftSampleData.data(), true);
+                // for thread-safety. ScopedTryLockType automatically unlocks at end of block using RAII
+                // ScopedTryLockType "tries" to lock. If lock acquired, safe to access shared data
+                // if UI thread is busy (i.e. holding the lock) ScopedTryLockType fails to get lock; isLocked() returns false
+                // analysis thread continues
+                // otherwise ScopedTryLockType gets the lock right away and isLocked() returns true =>
+                // code in if block below executes
+                // end result: achieve thread safety and don't let the analysis thread fall behind the audio
+                // try-lock pattern =>
+                // make sure analysis thread doesn't have to wait: either succeed or fail and move on
+                juce::SpinLock::ScopedTryLockType tryLock(levelsLock);
+                if (tryLock.isLocked())
+                {
+                    TDV_TRACE_SCOPE("levelsLock held (analysis)");
+                    levels.clearQuick();
+                    applyLogarithmicFreqMapping();
+                }
+                else
+                {
+                    // lock is busy, skip frame
+                    TDV_TRACE_INSTANT("levelsLock busy, frame skipped (analysis)");
+                }
+
+                // keep the newest (fftSize - hop) samples for the next, overlapping frame
+                const auto hop = fftSize / juce::jlimit(1, 8, overlap.load(std::memory_order_relaxed));
+                std::copy(samples.begin() + hop, samples.end(), samples.begin());
+                index = fftSize - hop;
+            }
+            samples[(size_t)index++] = sample;
+        }
+
+        void applyLogarithmicFreqMapping() {
+            auto mindB = -100.0f;
+            auto maxdB = 0.0f;
+            for (int i = 0; i < scopeSize; ++i)
+            {
+                auto fftDataIndex = bandTable[(size_t)i];
+                auto decibelsAtIndex = juce::Decibels::gainToDecibels(fftSampleData.at(fftDataIndex));
+                auto sourceValue = juce::jlimit(mindB, maxdB, decibelsAtIndex) - juce::Decibels::gainToDecibels((float)fftSize);
+                auto level = juce::jmap(
+                    sourceValue, // sourceValue
+                    mindB, // sourceRangeMin
+                    maxdB, // sourceRangeMax
+                    0.0f,  // targetRangeMin
+                    1.0f); // targetRangeMax
+                // guarantee level between 0 and 1;
+                level = juce::jlimit(0.0f, 1.0f, level);
+                levels.add(level);
+            }
+        }
+
+    };
+}
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    Chooses how much analysis data the editor publishes, based on the frame
+    times the WebGL frontend reports through the webFrameTimes native function.
+
+    A machine that can't keep up steps down (slower timer, fewer bins, less FFT
+    overlap, smaller FFT) instead of stuttering; it steps back up once frames
+    are fast again.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace webview_plugin
+{
+    class FrameBudget
+    {
+    public:
+        struct Quality
+        {
+            int timerIntervalMs;
+            int publishedBins;
+            int fftOverlap;
+            int fftOrder;
+        };
+
+        // best first; the editor starts at defaultLevel (the original 60 ms / 512 bins / 2048 point FFT)
+        static constexpr std::array<Quality, 4> levels{ {
+            { 30, 512, 4, 12 },
+            { 60, 512, 2, 11 },
+            { 90, 256, 1, 11 },
+            { 120, 128, 1, 10 }
+        } };
+        static constexpr size_t defaultLevel{ 1 };
+
+        // 60 fps
+        static constexpr auto frameBudgetMs{ 1000.0 / 60.0 };
+
+        // returns true if the quality level changed
+        bool reportFrameTimes(double averageMs, double worstMs) noexcept
+        {
+            // below ~48 fps on average, or a hitch of three frames or more, counts as slow
+            const auto isSlow = averageMs > frameBudgetMs * 1.25 || worstMs > frameBudgetMs * 3.0;
+            // close to the budget with no real hitches counts as fast
+            const auto isFast = averageMs < frameBudgetMs * 1.1 && worstMs < frameBudgetMs * 2.0;
+
+            slowReports = isSlow ? slowReports + 1 : 0;
+            fastReports = isFast ? fastReports + 1 : 0;
+
+            // degrade quickly, recover slowly, so the level doesn't oscillate
+            if (slowReports >= reportsBeforeDegrade && levelIndex < levels.size() - 1)
+            {
+                ++levelIndex;
+                slowReports = fastReports = 0;
+                return true;
+            }
+
+            if (fastReports >= reportsBeforeImprove && levelIndex > 0)
+            {
+                --levelIndex;
+                slowReports = fastReports = 0;
+                return true;
+            }
+
+            return false;
+        }
+
+        const Quality& getQuality() const noexcept { return levels[levelIndex]; }
+
+    private:
+        static constexpr auto reportsBeforeDegrade{ 2 };
+        static constexpr auto reportsBeforeImprove{ 6 };
+
+        size_t levelIndex{ defaultLevel };
+        int slowReports{ 0 };
+        int fastReports{ 0 };
+    };
+}
@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+    ITU-R BS.1770 loudness and true-peak metering.
+
+  ==============================================================================
+*/
+
+#include "LoudnessMeter.h"
+
+namespace webview_plugin
+{
+    void LoudnessMeter::prepare(double sampleRate)
+    {
+        designKWeighting(sampleRate);
+        designTruePeakInterpolator();
+        samplesPerGatingBlock = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+        reset();
+    }
+
+    void LoudnessMeter::reset()
+    {
+        shelf.reset();
+        highPass.reset();
+
+        for (auto& channelHistory : history)
+            channelHistory.fill(0.0f);
+        historyIndex = 0;
+
+        blockMeanSquares.fill(0.0);
+        blockPeaks.fill(0.0f);
+        blockWriteIndex = 0;
+        numFilledBlocks = 0;
+
+        samplesInGatingBlock = 0;
+        gatingBlockEnergy = 0.0;
+        gatingBlockPeak = 0.0f;
+
+        momentaryLufs = silenceLufs;
+        shortTermLufs = silenceLufs;
+        truePeakDecibels = silenceDecibels;
+    }
+
+    // BS.1770 specifies the filters at 48kHz; re-derive them through the bilinear transform
+    // for any sample rate (same analogue prototypes as libebur128)
+    void LoudnessMeter::designKWeighting(double sampleRate)
+    {
+        {
+            constexpr auto f0{ 1681.974450955533 };
+            constexpr auto gaindB{ 3.999843853973347 };
+            constexpr auto q{ 0.7071752369554196 };
+
+            const auto k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+            const auto vh = std::pow(10.0, gaindB / 20.0);
+            const auto vb = std::pow(vh, 0.4996667741545416);
+            const auto a0 = 1.0 + k / q + k * k;
+
+            shelf.b0 = (vh + vb * k / q + k * k) / a0;
+            shelf.b1 = 2.0 * (k * k - vh) / a0;
+            shelf.b2 = (vh - vb * k / q + k * k) / a0;
+            shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+            shelf.a2 = (1.0 - k / q + k * k) / a0;
+        }
+
+        {
+            constexpr auto f0{ 38.13547087602444 };
+            constexpr auto q{ 0.5003270373238773 };
+
+            const auto k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+            const auto a0 = 1.0 + k / q + k * k;
+
+            highPass.b0 = 1.0;
+            highPass.b1 = -2.0;
+            highPass.b2 = 1.0;
+            highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+            highPass.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+
+    // Blackman-windowed sinc low-pass at the original Nyquist, split into polyphase branches;
+    // each branch is normalised to unity DC gain
+    void LoudnessMeter::designTruePeakInterpolator()
+    {
+        constexpr auto numTaps{ oversampling * tapsPerPhase };
+        constexpr auto centre{ (numTaps - 1) * 0.5 };
+        constexpr auto pi{ juce::MathConstants<double>::pi };
+
+        for (int phase = 0; phase < oversampling; ++phase)
+        {
+            auto sum{ 0.0 };
+            std::array<double, tapsPerPhase> taps{};
+
+            for (int k = 0; k < tapsPerPhase; ++k)
+            {
+                const auto n = k * oversampling + phase;
+                const auto x = (n - centre) / oversampling;
+                const auto sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(pi * x) / (pi * x);
+                const auto window = 0.42 - 0.5 * std::cos(2.0 * pi * n / (numTaps - 1))
+                                  + 0.08 * std::cos(4.0 * pi * n / (numTaps - 1));
+                taps[(size_t)k] = sinc * window;
+                sum += taps[(size_t)k];
+            }
+
+            for (int k = 0; k < tapsPerPhase; ++k)
+                polyphase[(size_t)phase][(size_t)k] = static_cast<float>(taps[(size_t)k] / sum);
+        }
+    }
+
+    void LoudnessMeter::process(const float* const* channels, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            Frame x;
+            for (size_t ch = 0; ch < numChannels; ++ch)
+                x[ch] = channels[ch][i];
+
+            gatingBlockPeak = juce::jmax(gatingBlockPeak, processTruePeak(x));
+
+            const auto weighted = highPass.process(shelf.process(x));
+
+            // channel weights are 1.0 for left and right
+            for (size_t ch = 0; ch < numChannels; ++ch)
+                gatingBlockEnergy += weighted[ch] * weighted[ch];
+
+            if (++samplesInGatingBlock == samplesPerGatingBlock)
+                finishGatingBlock();
+        }
+    }
+
+    float LoudnessMeter::processTruePeak(const Frame& x) noexcept
+    {
+        historyIndex = (historyIndex == 0 ? tapsPerPhase : historyIndex) - 1;
+
+        auto peak{ 0.0f };
+        for (size_t ch = 0; ch < numChannels; ++ch)
+        {
+            auto& channelHistory = history[ch];
+            const auto sample = static_cast<float>(x[ch]);
+            channelHistory[(size_t)historyIndex] = sample;
+            channelHistory[(size_t)(historyIndex + tapsPerPhase)] = sample;
+
+            // newest sample first
+            const auto* window = channelHistory.data() + historyIndex;
+
+            for (const auto& taps : polyphase)
+            {
+                auto interpolated{ 0.0f };
+                for (size_t k = 0; k < tapsPerPhase; ++k)
+                    interpolated += taps[k] * window[k];
+
+                peak = juce::jmax(peak, std::abs(interpolated));
+            }
+
+            peak = juce::jmax(peak, std::abs(sample));
+        }
+
+        return peak;
+    }
+
+    void LoudnessMeter::finishGatingBlock() noexcept
+    {
+        blockMeanSquares[(size_t)blockWriteIndex] = gatingBlockEnergy / samplesPerGatingBlock;
+        blockPeaks[(size_t)blockWriteIndex] = gatingBlockPeak;
+        blockWriteIndex = (blockWriteIndex + 1) % numShortTermBlocks;
+        numFilledBlocks = juce::jmin(numFilledBlocks + 1, numShortTermBlocks);
+
+        samplesInGatingBlock = 0;
+        gatingBlockEnergy = 0.0;
+        gatingBlockPeak = 0.0f;
+
+        // walk backwards from the newest block
+        auto momentarySum{ 0.0 };
+        auto shortTermSum{ 0.0 };
+        auto peak{ 0.0f };
+
+        for (int i = 0; i < numFilledBlocks; ++i)
+        {
+            const auto index = (size_t)((blockWriteIndex - 1 - i + numShortTermBlocks) % numShortTermBlocks);
+            if (i < numMomentaryBlocks)
+                momentarySum += blockMeanSquares[index];
+            shortTermSum += blockMeanSquares[index];
+            peak = juce::jmax(peak, blockPeaks[index]);
+        }
+
+        momentaryLufs.store(meanSquareToLufs(momentarySum / juce::jmin(numFilledBlocks, numMomentaryBlocks)), std::memory_order_relaxed);
+        shortTermLufs.store(meanSquareToLufs(shortTermSum / numFilledBlocks), std::memory_order_relaxed);
+        truePeakDecibels.store(juce::Decibels::gainToDecibels(peak, silenceDecibels), std::memory_order_relaxed);
+    }
+
+    float LoudnessMeter::meanSquareToLufs(double meanSquare) noexcept
+    {
+        if (meanSquare <= 0.0)
+            return silenceLufs;
+
+        return juce::jmax(silenceLufs, static_cast<float>(-0.691 + 10.0 * std::log10(meanSquare)));
+    }
+}
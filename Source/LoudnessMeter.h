@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    ITU-R BS.1770 loudness (momentary / short-term LUFS) and 4x oversampled
+    true-peak metering of the wet output.
+
+    Runs on the analysis thread; results are published through atomics.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace webview_plugin
+{
+    class LoudnessMeter
+    {
+    public:
+        static constexpr auto numChannels{ 2 };
+        // display floor; matches the BS.1770 absolute gate
+        static constexpr auto silenceLufs{ -70.0f };
+        static constexpr auto silenceDecibels{ -100.0f };
+
+        // call while the analysis thread is stopped
+        void prepare(double sampleRate);
+        void reset();
+
+        void process(const float* const* channels, int numSamples) noexcept;
+
+        float getMomentaryLufs() const noexcept { return momentaryLufs.load(std::memory_order_relaxed); }
+        float getShortTermLufs() const noexcept { return shortTermLufs.load(std::memory_order_relaxed); }
+        float getTruePeakDecibels() const noexcept { return truePeakDecibels.load(std::memory_order_relaxed); }
+
+    private:
+        using Frame = std::array<double, numChannels>;
+
+        // transposed direct form II; both channels step through the filter in lockstep
+        // so each lane-wise loop compiles to a single SIMD operation
+        struct StereoBiquad
+        {
+            double b0{ 1.0 }, b1{ 0.0 }, b2{ 0.0 }, a1{ 0.0 }, a2{ 0.0 };
+            Frame z1{}, z2{};
+
+            Frame process(const Frame& x) noexcept
+            {
+                Frame y;
+                for (size_t ch = 0; ch < numChannels; ++ch)
+                {
+                    y[ch] = b0 * x[ch] + z1[ch];
+                    z1[ch] = b1 * x[ch] - a1 * y[ch] + z2[ch];
+                    z2[ch] = b2 * x[ch] - a2 * y[ch];
+                }
+                return y;
+            }
+
+            void reset() noexcept
+            {
+                z1 = {};
+                z2 = {};
+            }
+        };
+
+        void designKWeighting(double sampleRate);
+        void designTruePeakInterpolator();
+        float processTruePeak(const Frame& x) noexcept;
+        void finishGatingBlock() noexcept;
+        static float meanSquareToLufs(double meanSquare) noexcept;
+
+        // K-weighting: pre-filter (high shelf) then RLB high-pass
+        StereoBiquad shelf;
+        StereoBiquad highPass;
+
+        // true peak: 48-tap interpolator split into 4 polyphase branches
+        static constexpr auto oversampling{ 4 };
+        static constexpr auto tapsPerPhase{ 12 };
+        std::array<std::array<float, tapsPerPhase>, oversampling> polyphase{};
+        // history is stored twice so the newest tapsPerPhase samples are always contiguous
+        std::array<std::array<float, tapsPerPhase * 2>, numChannels> history{};
+        int historyIndex{ 0 };
+
+        // 100 ms gating blocks; momentary = last 4 (400 ms), short-term = last 30 (3 s)
+        static constexpr auto numMomentaryBlocks{ 4 };
+        static constexpr auto numShortTermBlocks{ 30 };
+        std::array<double, numShortTermBlocks> blockMeanSquares{};
+        std::array<float, numShortTermBlocks> blockPeaks{};
+        int blockWriteIndex{ 0 };
+        int numFilledBlocks{ 0 };
+
+        int samplesPerGatingBlock{ 4410 };
+        int samplesInGatingBlock{ 0 };
+        double gatingBlockEnergy{ 0.0 };
+        float gatingBlockPeak{ 0.0f };
+
+        std::atomic<float> momentaryLufs{ silenceLufs };
+        std::atomic<float> shortTermLufs{ silenceLufs };
+        std::atomic<float> truePeakDecibels{ silenceDecibels };
+    };
+}
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    Reverb parameter changes on their way to the audio thread.
+
+    Any thread (host automation, message thread, audio thread) may push;
+    only processBlock() pops. Storage is preallocated and push/pop never
+    lock or allocate.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace webview_plugin
+{
+    struct ParameterEvent
+    {
+        int parameter{ 0 };
+        float value{ 0.0f };
+    };
+
+    // bounded multi-producer / single-consumer queue (Vyukov's sequence-numbered ring)
+    class ParameterEventQueue
+    {
+    public:
+        static constexpr size_t capacity{ 1024 };
+
+        ParameterEventQueue() noexcept
+        {
+            for (size_t i = 0; i < capacity; ++i)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        // any thread; returns false if the queue is full (the event is dropped)
+        bool push(const ParameterEvent& event) noexcept
+        {
+            auto position = enqueuePosition.load(std::memory_order_relaxed);
+
+            for (;;)
+            {
+                auto& cell = cells[position & mask];
+                const auto sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+                if (difference == 0)
+                {
+                    if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        cell.event = event;
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // audio thread only
+        bool pop(ParameterEvent& event) noexcept
+        {
+            auto& cell = cells[dequeuePosition & mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+
+            if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(dequeuePosition + 1) < 0)
+                return false;
+
+            event = cell.event;
+            cell.sequence.store(dequeuePosition + capacity, std::memory_order_release);
+            ++dequeuePosition;
+            return true;
+        }
+
+    private:
+        static constexpr size_t mask{ capacity - 1 };
+        static_assert((capacity & mask) == 0, "capacity must be a power of two");
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence{ 0 };
+            ParameterEvent event;
+        };
+
+        std::array<Cell, capacity> cells;
+        std::atomic<size_t> enqueuePosition{ 0 };
+        size_t dequeuePosition{ 0 };
+
+        JUCE_DECLARE_NON_COPYABLE(ParameterEventQueue)
+    };
+}
@@ -56,6 +56,7 @@ namespace webview_plugin
         // takes property string and the value to send to the frontend and returns a juce::WebBrowserComponent::Resource
         juce::WebBrowserComponent::Resource getPreparedResource(const juce::Identifier property, juce::var valueToSet)
         {
+            TDV_TRACE_SCOPE("JSON serialization");
             juce::DynamicObject::Ptr data{ new juce::DynamicObject };
             data->setProperty(property, valueToSet);
             const auto string = juce::JSON::toString(data.get());
@@ -134,12 +135,17 @@ namespace webview_plugin
         
         setResizable(false, false);
         setSize(1366, 768);
-        startTimer(60);
+        applyQuality(frameBudget.getQuality());
+        // nothing reads the analysis while the editor is closed
+        audioProcessor.setAnalysisEnabled(true);
     }
 
     ThreeDVerbAudioProcessorEditor::~ThreeDVerbAudioProcessorEditor()
     {
         stopTimer();
+        audioProcessor.setAnalysisEnabled(false);
+        // closing the window mid-drag never delivers the slider's change event
+        audioProcessor.endMorphGesture();
     }
 
     juce::WebBrowserComponent::Options ThreeDVerbAudioProcessorEditor::getWebViewOptions()
@@ -177,8 +183,39 @@ namespace webview_plugin
                     webUndoRedo(args, std::move(completion));
                 }
             )
-            .withEventListener("undoRequest", [this](juce::var undoButton) { undoManager.undo(); })
-            .withEventListener("redoRequest", [this](juce::var redoButton) { undoManager.redo(); })
+            .withNativeFunction(
+                juce::Identifier{ "webTracing" },
+                [this](
+                    const juce::Array<juce::var>& args,
+                    juce::WebBrowserComponent::NativeFunctionCompletion completion
+                    )
+                {
+                    webTracing(args, std::move(completion));
+                }
+            )
+            .withNativeFunction(
+                juce::Identifier{ "webFrameTimes" },
+                [this](
+                    const juce::Array<juce::var>& args,
+                    juce::WebBrowserComponent::NativeFunctionCompletion completion
+                    )
+                {
+                    webFrameTimes(args, std::move(completion));
+                }
+            )
+            .withNativeFunction(
+                juce::Identifier{ "webSnapshot" },
+                [this](
+                    const juce::Array<juce::var>& args,
+                    juce::WebBrowserComponent::NativeFunctionCompletion completion
+                    )
+                {
+                    webSnapshot(args, std::move(completion));
+                }
+            )
+            // a button press closes any open transaction first so it can't absorb later changes
+            .withEventListener("undoRequest", [this](juce::var undoButton) { undoManager.beginNewTransaction(); undoManager.undo(); })
+            .withEventListener("redoRequest", [this](juce::var redoButton) { undoManager.beginNewTransaction(); undoManager.redo(); })
 
             .withOptionsFrom(webGainRelay)
             .withOptionsFrom(webBypassRelay)
@@ -200,7 +237,9 @@ namespace webview_plugin
 
     void ThreeDVerbAudioProcessorEditor::timerCallback()
     {
+       TDV_TRACE_SCOPE("timerCallback");
        webView.emitEventIfBrowserIsVisible("outputLevel", juce::var{});
+       webView.emitEventIfBrowserIsVisible("loudness", juce::var{});
        webView.emitEventIfBrowserIsVisible("isFrozen", juce::var{});
        webView.emitEventIfBrowserIsVisible("mixValue", juce::var{});
        webView.emitEventIfBrowserIsVisible("roomSizeValue", juce::var{});
@@ -235,15 +274,110 @@ namespace webview_plugin
         keyPressed(kp);
     }
 
+    // args[0] == true starts a trace session; false stops it and writes Chrome/Perfetto trace JSON
+    void ThreeDVerbAudioProcessorEditor::webTracing(const juce::Array<juce::var>& args,
+        juce::WebBrowserComponent::NativeFunctionCompletion completion)
+    {
+        auto& tracer = tracing::Tracer::getInstance();
+
+        if (static_cast<bool>(args[0]))
+        {
+            tracer.setEnabled(true);
+            completion("Tracing started");
+            return;
+        }
+
+        const auto traceFile = tracing::Tracer::getDefaultTraceFile();
+        const auto result = tracer.writeChromeTrace(traceFile);
+        result.wasOk() ? completion("Trace written to " + traceFile.getFullPathName())
+                       : completion(result.getErrorMessage());
+    }
+
+    // args[0] == average frame time (ms), args[1] == worst frame time (ms) since the last report
+    void ThreeDVerbAudioProcessorEditor::webFrameTimes(const juce::Array<juce::var>& args,
+        juce::WebBrowserComponent::NativeFunctionCompletion completion)
+    {
+        if (frameBudget.reportFrameTimes(static_cast<double>(args[0]), static_cast<double>(args[1])))
+            applyQuality(frameBudget.getQuality());
+
+        completion(frameBudget.getQuality().publishedBins);
+    }
+
+    // args[0] == "store" or "recall" with args[1] == slot (0 == A, 1 == B, 2.. numbered),
+    // "morph" with args[1] == amount between A (0) and B (1), or "morphStart" / "morphEnd" around a drag
+    void ThreeDVerbAudioProcessorEditor::webSnapshot(const juce::Array<juce::var>& args,
+        juce::WebBrowserComponent::NativeFunctionCompletion completion)
+    {
+        const auto action = args[0].toString();
+
+        if (action == "morph")
+        {
+            audioProcessor.morphSnapshots(static_cast<float>(args[1]));
+            completion("Morphing");
+            return;
+        }
+
+        if (action == "morphStart" || action == "morphEnd")
+        {
+            action == "morphStart" ? audioProcessor.beginMorphGesture() : audioProcessor.endMorphGesture();
+            completion(action);
+            return;
+        }
+
+        const auto slot = static_cast<int>(args[1]);
+        if (!juce::isPositiveAndBelow(slot, SnapshotBank::numSlots))
+        {
+            completion("No such snapshot slot");
+            return;
+        }
+
+        const auto name = SnapshotBank::getSlotName(slot);
+
+        if (action == "store")
+        {
+            audioProcessor.storeSnapshot(slot);
+            completion("Stored snapshot " + name);
+        }
+        else if (action == "recall")
+        {
+            audioProcessor.snapshots.isStored(slot) ? completion("Recalling snapshot " + name)
+                                                    : completion("Snapshot " + name + " is empty");
+            audioProcessor.recallSnapshot(slot);
+        }
+        else
+        {
+            completion("Unknown snapshot action");
+        }
+    }
+
+    void ThreeDVerbAudioProcessorEditor::applyQuality(const FrameBudget::Quality& quality)
+    {
+        startTimer(quality.timerIntervalMs);
+        publishedBins = quality.publishedBins;
+        audioProcessor.analysis.setFftOrder(quality.fftOrder);
+        audioProcessor.analysis.setFftOverlap(quality.fftOverlap);
+    }
+
     std::optional<juce::WebBrowserComponent::Resource> ThreeDVerbAudioProcessorEditor::getResource(const juce::String& url)
     {
+        TDV_TRACE_SCOPE("getResource");
         //static const auto resourceFileRoot = juce::File{ R"(C:\Users\Joe\source\repos\Reverbulizer\Source\ui\public)"};
         static const auto resourceDirectory = getResourceDirectory();
         const auto resourceToRetrieve = url == "/" ? "index.html" : url.fromFirstOccurrenceOf("/", false, false);
 
         if (resourceToRetrieve == "outputLevel.json")
         {
-            return getPreparedResource("left", audioProcessor.outputLevelLeft.load());
+            return getPreparedResource("left", audioProcessor.analysis.getOutputLevelDecibels());
+        }
+
+        if (resourceToRetrieve == "loudness.json")
+        {
+            const auto& meter = audioProcessor.analysis.getLoudnessMeter();
+            juce::DynamicObject::Ptr loudness{ new juce::DynamicObject };
+            loudness->setProperty("momentary", meter.getMomentaryLufs());
+            loudness->setProperty("shortTerm", meter.getShortTermLufs());
+            loudness->setProperty("truePeak", meter.getTruePeakDecibels());
+            return getPreparedResource("loudness", loudness.get());
         }
 
         if (resourceToRetrieve == "freeze.json")
@@ -276,10 +410,31 @@ namespace webview_plugin
         {
             juce::Array<juce::var> threadSafeLevels;
             {
-                const juce::SpinLock::ScopedLockType lock(audioProcessor.fifo.levelsLock);
-                if (audioProcessor.fifo.levels.size() != audioProcessor.getScopeSize())
+                TDV_TRACE_SCOPE("levelsLock wait + copy (message)");
+                auto& spectrum = audioProcessor.analysis.getSpectrum();
+                const juce::SpinLock::ScopedLockType lock(spectrum.levelsLock);
+                if (spectrum.levels.size() != spectrum.getScopeSize())
                     return {};
-                threadSafeLevels = audioProcessor.fifo.levels;
+                threadSafeLevels = spectrum.levels;
+            }
+
+            // fewer bins when the frontend is behind; keep the loudest bin of each group
+            const auto numBins = juce::jlimit(1, threadSafeLevels.size(), publishedBins.load());
+            if (numBins < threadSafeLevels.size())
+            {
+                const auto groupSize = threadSafeLevels.size() / numBins;
+                juce::Array<juce::var> reducedLevels;
+                reducedLevels.ensureStorageAllocated(numBins);
+
+                for (int bin = 0; bin < numBins; ++bin)
+                {
+                    auto level{ 0.0f };
+                    for (int i = 0; i < groupSize; ++i)
+                        level = juce::jmax(level, static_cast<float>(threadSafeLevels.getReference(bin * groupSize + i)));
+                    reducedLevels.add(level);
+                }
+
+                threadSafeLevels.swapWith(reducedLevels);
             }
 
             return getPreparedResource("levels", threadSafeLevels);
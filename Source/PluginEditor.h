@@ -10,6 +10,7 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "FrameBudget.h"
 
 //==============================================================================
 /**
@@ -37,12 +38,23 @@ namespace webview_plugin
 		
 		void webUndoRedo(const juce::Array<juce::var>& args,
 			juce::WebBrowserComponent::NativeFunctionCompletion completion);
+		void webTracing(const juce::Array<juce::var>& args,
+			juce::WebBrowserComponent::NativeFunctionCompletion completion);
+		void webFrameTimes(const juce::Array<juce::var>& args,
+			juce::WebBrowserComponent::NativeFunctionCompletion completion);
+		void webSnapshot(const juce::Array<juce::var>& args,
+			juce::WebBrowserComponent::NativeFunctionCompletion completion);
+		void applyQuality(const FrameBudget::Quality& quality);
 		// This reference is provided as a quick way for your editor to
 		// access the processor object that created it.
 		ThreeDVerbAudioProcessor& audioProcessor;
 
 		juce::UndoManager& undoManager;
 
+		FrameBudget frameBudget;
+		// read in getResource()
+		std::atomic<int> publishedBins{ FrameBudget::levels[FrameBudget::defaultLevel].publishedBins };
+
 		// BEGIN WEB VIEW
 		juce::WebSliderRelay webGainRelay;
 		juce::WebToggleButtonRelay webBypassRelay;
@@ -75,12 +75,27 @@ namespace webview_plugin
         freeze{ dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(id::FREEZE.getParamID())) }
     {
         apvts.addParameterListener(id::GAIN.getParamID(), this);
+        for (const auto& parameterID : { id::SIZE, id::MIX, id::WIDTH, id::DAMP, id::FREEZE })
+            apvts.addParameterListener(parameterID.getParamID(), this);
+        setUndoHistoryLimit(defaultUndoHistoryTransactions);
+        // keeps the parameters in line with snapshot recalls done on the audio thread
+        startTimerHz(30);
     }
 
     ThreeDVerbAudioProcessor::~ThreeDVerbAudioProcessor()
     {
     }
 
+    // each slider gesture from the frontend is one transaction, and repeated changes to the same
+    // parameter inside it coalesce into one action, so undo/redo cost doesn't grow with the history
+    void ThreeDVerbAudioProcessor::setUndoHistoryLimit(int maxTransactions)
+    {
+        // JUCE sizes actions in bytes (a ValueTree SetPropertyAction reports sizeof(*this)), which says
+        // little about how many steps fit. With a 1 unit budget it drops the oldest transaction whenever
+        // there are more than minTransactions, so the second argument becomes an exact transaction cap
+        undoManager.setMaxNumberOfStoredUnits(1, juce::jmax(1, maxTransactions));
+    }
+
     //==============================================================================
     const juce::String ThreeDVerbAudioProcessor::getName() const
     {
@@ -116,27 +131,44 @@ namespace webview_plugin
 
     double ThreeDVerbAudioProcessor::getTailLengthSeconds() const
     {
-        return 0.0;
+        // freeze mode holds the tail indefinitely
+        if (freeze->get() >= 0.5f)
+            return std::numeric_limits<double>::infinity();
+
+        // juce::Reverb (Freeverb) maps room size to comb feedback as roomSize * 0.28 + 0.7
+        // the longest comb (1617 samples + 23 stereo spread @ 44.1kHz) sets how long one pass through the tank takes
+        // count the passes needed for the feedback to fall 60dB (RT60); damping only shortens this so ignore it
+        constexpr auto longestCombSeconds{ (1617.0 + 23.0) / 44100.0 };
+        constexpr auto decaydB{ -60.0 };
+        const auto feedback = juce::jlimit(0.0, 0.999, (double)size->get() * 0.28 + 0.7);
+        const auto numPasses = decaydB / juce::Decibels::gainToDecibels(feedback);
+
+        return numPasses * longestCombSeconds;
     }
 
+    // programs 1.. are the snapshot slots, so hosts can switch scenes with program changes.
+    // Program 0 stands for settings that aren't in any slot (nothing stored or recalled yet, or
+    // a morph); selecting it changes nothing
     int ThreeDVerbAudioProcessor::getNumPrograms()
     {
-        return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-        // so this should be at least 1, even if you're not really implementing programs.
+        return SnapshotBank::numSlots + 1;
     }
 
     int ThreeDVerbAudioProcessor::getCurrentProgram()
     {
-        return 0;
+        const auto slot = currentSnapshot.load();
+        return slot == noSnapshot ? 0 : slot + 1;
     }
 
     void ThreeDVerbAudioProcessor::setCurrentProgram(int index)
     {
+        if (index > 0)
+            recallSnapshot(index - 1);
     }
 
     const juce::String ThreeDVerbAudioProcessor::getProgramName(int index)
     {
-        return {};
+        return index == 0 ? "Current settings" : SnapshotBank::getSlotName(index - 1);
     }
 
     void ThreeDVerbAudioProcessor::changeProgramName(int index, const juce::String& newName)
@@ -151,22 +183,72 @@ namespace webview_plugin
         juce::dsp::ProcessSpec spec{};
 
         spec.sampleRate = sampleRate;
-        spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
+        // processBlock() never hands more than subBlockSize samples to the DSP below
+        spec.maximumBlockSize = static_cast<juce::uint32>(subBlockSize);
         spec.numChannels = static_cast<juce::uint32>(getTotalNumOutputChannels());
 
         smoothedGain.reset(sampleRate, 0.001);
-       
-        envelopeFollower.prepare(spec);
-        setEnvFollowerParams(envelopeFollower);
-        envelopeFollowerOutputBuffer.setSize(getTotalNumOutputChannels(), samplesPerBlock);
 
-        reverb.prepare(spec);
+        for (auto& r : reverbs)
+            r.prepare(spec);
+        reverb = &reverbs[0];
+        fadingReverb = nullptr;
+        // two channels even on a mono bus, see processFadingReverb()
+        crossfadeBuffer.setSize(juce::jmax(2, static_cast<int>(spec.numChannels)), static_cast<int>(subBlockSize));
+        crossfadeLengthSamples = juce::jmax(1, juce::roundToInt(sampleRate * snapshotCrossfadeSeconds));
+        crossfadeSamplesRemaining = 0;
+        // start from the current values; anything queued before now is already reflected in them
+        ParameterEvent stale;
+        while (parameterEvents.pop(stale)) {}
+        // both tanks are empty, so a mono switch needs no crossfade here
+        reverbIsMono = mono.get() && getTotalNumInputChannels() >= 2;
+        updateReverb();
+        isRamping = false;
+
+        // FFT, loudness and output level run on their own thread, fed from processBlock(),
+        // but only while an editor is open
+        const juce::ScopedLock lock(analysisLock);
+        analysis.stopThread(1000);
+        analysis.prepare(sampleRate);
+        isAnalysisPrepared = true;
+        updateAnalysisThread();
     }
 
     void ThreeDVerbAudioProcessor::releaseResources()
     {
         // When playback stops, you can use this as an opportunity to free up any
         // spare memory, etc.
+        const juce::ScopedLock lock(analysisLock);
+        isAnalysisPrepared = false;
+        updateAnalysisThread();
+    }
+
+    void ThreeDVerbAudioProcessor::setAnalysisEnabled(bool shouldBeEnabled)
+    {
+        const juce::ScopedLock lock(analysisLock);
+        analysisEnabled = shouldBeEnabled;
+        updateAnalysisThread();
+    }
+
+    void ThreeDVerbAudioProcessor::setAnalysisThreadEnabled(bool shouldRunThread)
+    {
+        const juce::ScopedLock lock(analysisLock);
+        isAnalysisThreadEnabled = shouldRunThread;
+        updateAnalysisThread();
+    }
+
+    // call with analysisLock held
+    void ThreeDVerbAudioProcessor::updateAnalysisThread()
+    {
+        if (analysisEnabled && isAnalysisPrepared && isAnalysisThreadEnabled)
+        {
+            if (!analysis.isThreadRunning())
+                analysis.startThread(juce::Thread::Priority::low);
+        }
+        else
+        {
+            analysis.stopThread(1000);
+        }
     }
 
     #ifndef JucePlugin_PreferredChannelConfigurations
@@ -190,26 +272,289 @@ namespace webview_plugin
 
     void ThreeDVerbAudioProcessor::updateReverb()
     {
-        params.roomSize = size->get();
-        params.wetLevel = mix->get();
-        params.dryLevel = 1.0f - mix->get();
-        params.width = width->get();
-        params.damping = damp->get();
-        params.freezeMode = freeze->get();
+        applySnapshotToParams(getCurrentSnapshot());
+        setReverbParameters(*reverb);
+    }
+
+    // juce::Reverb's mono path feeds its tank x * gain where the stereo path feeds (L + R) * gain,
+    // and it only applies wetGain1 = 0.5 * wet * (1 + width) where stereo applies wet1 + wet2 = wet.
+    // Width 1 and double the wet level bring mono back to the stereo wet level (within ~1 dB for
+    // identical L/R, since the stereo path sums two decorrelated tanks); the dry level is unchanged
+    void ThreeDVerbAudioProcessor::setReverbParameters(juce::dsp::Reverb& target)
+    {
+        auto adjusted = params;
+
+        if (reverbIsMono)
+        {
+            adjusted.width = 1.0f;
+            adjusted.wetLevel *= 2.0f;
+        }
+
+        target.setParameters(adjusted);
+    }
+
+    ReverbSnapshot ThreeDVerbAudioProcessor::getCurrentSnapshot() const
+    {
+        return { size->get(), mix->get(), width->get(), damp->get(), freeze->get() };
+    }
+
+    void ThreeDVerbAudioProcessor::applySnapshotToParams(const ReverbSnapshot& snapshot)
+    {
+        params.roomSize = snapshot.size;
+        params.wetLevel = snapshot.mix;
+        params.dryLevel = 1.0f - snapshot.mix;
+        params.width = snapshot.width;
+        params.damping = snapshot.damp;
+        params.freezeMode = snapshot.freeze;
+    }
+
+    void ThreeDVerbAudioProcessor::storeSnapshot(int slot)
+    {
+        if (juce::isPositiveAndBelow(slot, SnapshotBank::numSlots))
+        {
+            snapshots.store(slot, getCurrentSnapshot());
+            currentSnapshot = slot;
+        }
+    }
+
+    void ThreeDVerbAudioProcessor::recallSnapshot(int slot)
+    {
+        if (snapshots.isStored(slot))
+            requestedSnapshot = slot;
+    }
+
+    void ThreeDVerbAudioProcessor::morphSnapshots(float amount)
+    {
+        requestedMorph = juce::jlimit(0.0f, 1.0f, amount);
+    }
+
+    // audio thread, at the start of a block
+    void ThreeDVerbAudioProcessor::applyPendingSnapshot(bool shouldCrossfade)
+    {
+        // a recall waits for a running crossfade to finish rather than cutting the outgoing tail short
+        if (fadingReverb == nullptr)
+        {
+            ReverbSnapshot snapshot;
+            const auto slot = requestedSnapshot.exchange(noSnapshot);
+
+            if (slot != noSnapshot && snapshots.load(slot, snapshot))
+            {
+                applySnapshotToParams(snapshot);
+
+                if (shouldCrossfade)
+                    startCrossfade();
+
+                setReverbParameters(*reverb);
+                // the recalled values win over automation queued for this block
+                isRamping = false;
+
+                currentSnapshot = slot;
+                recalledSnapshot = slot;
+            }
+        }
+
+        if (const auto amount = requestedMorph.load(); amount >= 0.0f)
+        {
+            ReverbSnapshot a, b;
+            if (snapshots.load(SnapshotBank::slotA, a) && snapshots.load(SnapshotBank::slotB, b))
+            {
+                applySnapshotToParams(SnapshotBank::interpolate(a, b, amount));
+                setReverbParameters(*reverb);
+                isRamping = false;
+                currentSnapshot = noSnapshot;
+                recalledMorph = amount;
+            }
+
+            // cleared only after recalledMorph is set, so the message thread never sees the step in neither;
+            // a newer amount stays for the next block
+            auto expected = amount;
+            requestedMorph.compare_exchange_strong(expected, -1.0f);
+        }
+    }
+
+    // the outgoing tank keeps its settings and tail and fades out; the other one starts empty
+    // and fades in with whatever parameters are set on it next
+    void ThreeDVerbAudioProcessor::startCrossfade()
+    {
+        fadingReverb = reverb;
+        fadingReverbIsMono = reverbIsMono;
+        reverb = reverb == &reverbs[0] ? &reverbs[1] : &reverbs[0];
+        reverb->reset();
+        crossfadeSamplesRemaining = crossfadeLengthSamples;
+    }
+
+    // runs the outgoing reverb on a copy of block (the incoming reverb's input) and leaves its
+    // output in crossfadeBuffer with block's channel count
+    void ThreeDVerbAudioProcessor::processFadingReverb(juce::dsp::AudioBlock<float> block)
+    {
+        const auto numSamples = block.getNumSamples();
+        auto fadingBlock = juce::dsp::AudioBlock<float>{ crossfadeBuffer }.getSubBlock(0, numSamples);
+
+        if (fadingReverbIsMono == reverbIsMono)
+        {
+            auto fadingSubset = fadingBlock.getSubsetChannelBlock(0, block.getNumChannels());
+            fadingSubset.copyFrom(block);
+
+            juce::dsp::ProcessContextReplacing<float> fadingCtx{ fadingSubset };
+            fadingReverb->process(fadingCtx);
+        }
+        else if (fadingReverbIsMono)
+        {
+            // switched to stereo: the mono tank gets the mono sum and feeds both channels
+            auto fadingMono = fadingBlock.getSingleChannelBlock(0);
+            fadingMono.copyFrom(block.getSingleChannelBlock(0));
+            fadingMono.add(block.getSingleChannelBlock(1));
+            fadingMono.multiplyBy(0.5f);
+
+            juce::dsp::ProcessContextReplacing<float> fadingCtx{ fadingMono };
+            fadingReverb->process(fadingCtx);
+            fadingBlock.getSingleChannelBlock(1).copyFrom(fadingMono);
+        }
+        else
+        {
+            // switched to mono: the stereo tank gets the mono input on both channels and its output is summed
+            fadingBlock.getSingleChannelBlock(0).copyFrom(block);
+            fadingBlock.getSingleChannelBlock(1).copyFrom(block);
+
+            auto fadingStereo = fadingBlock.getSubsetChannelBlock(0, 2);
+            juce::dsp::ProcessContextReplacing<float> fadingCtx{ fadingStereo };
+            fadingReverb->process(fadingCtx);
+
+            auto fadingMono = fadingBlock.getSingleChannelBlock(0);
+            fadingMono.add(fadingBlock.getSingleChannelBlock(1));
+            fadingMono.multiplyBy(0.5f);
+        }
+    }
+
+    // block holds the incoming reverb's output, crossfadeBuffer the outgoing one's
+    void ThreeDVerbAudioProcessor::crossfadeFromFadingReverb(juce::dsp::AudioBlock<float> block)
+    {
+        const auto numSamples = static_cast<int>(block.getNumSamples());
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto remaining = juce::jmax(0, crossfadeSamplesRemaining - i);
+            crossfadeRamp[(size_t)i] = 1.0f - static_cast<float>(remaining) / static_cast<float>(crossfadeLengthSamples);
+        }
+
+        // linear, since the dry part of both signals is identical: out = fading + (incoming - fading) * ramp
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            auto* incoming = block.getChannelPointer(channel);
+            const auto* fading = crossfadeBuffer.getReadPointer(static_cast<int>(channel));
+
+            juce::FloatVectorOperations::subtract(incoming, fading, numSamples);
+            juce::FloatVectorOperations::multiply(incoming, crossfadeRamp.data(), numSamples);
+            juce::FloatVectorOperations::add(incoming, fading, numSamples);
+        }
+
+        crossfadeSamplesRemaining -= numSamples;
+        if (crossfadeSamplesRemaining <= 0)
+            fadingReverb = nullptr;
+    }
+
+    // recalls and morphs happen on the audio thread; afterwards the parameters (host, editor, undo)
+    // are brought in line here. Their change notifications reach the audio thread as ordinary events
+    void ThreeDVerbAudioProcessor::timerCallback()
+    {
+        applyRequestsWhileIdle();
+
+        ReverbSnapshot snapshot;
+
+        if (const auto slot = recalledSnapshot.exchange(noSnapshot); slot != noSnapshot && snapshots.load(slot, snapshot))
+            setParametersFromSnapshot(snapshot);
+
+        if (const auto amount = recalledMorph.exchange(-1.0f); amount >= 0.0f)
+        {
+            ReverbSnapshot a, b;
+            if (snapshots.load(SnapshotBank::slotA, a) && snapshots.load(SnapshotBank::slotB, b))
+                setParametersFromSnapshot(SnapshotBank::interpolate(a, b, amount));
+        }
+
+        if (isMorphGestureEnding && requestedMorph.load() < 0.0f && recalledMorph.load() < 0.0f)
+            finishMorphGesture();
+    }
+
+    // with no blocks coming (host stopped, no audio device) nobody would pick requests up, and the
+    // audio thread would start a crossfade whenever processing resumed; set the parameters instead.
+    // The exchanges make sure a request is taken by one thread only
+    void ThreeDVerbAudioProcessor::applyRequestsWhileIdle()
+    {
+        if (juce::Time::getMillisecondCounter() - lastBlockMs.load() < audioIdleTimeoutMs)
+            return;
 
-        reverb.setParameters(params);
+        if (const auto slot = requestedSnapshot.exchange(noSnapshot); slot != noSnapshot)
+        {
+            currentSnapshot = slot;
+            recalledSnapshot = slot;
+        }
+
+        if (const auto amount = requestedMorph.exchange(-1.0f); amount >= 0.0f)
+        {
+            currentSnapshot = noSnapshot;
+            recalledMorph = amount;
+        }
+    }
+
+    void ThreeDVerbAudioProcessor::setParametersFromSnapshot(const ReverbSnapshot& snapshot)
+    {
+        // one undo step per recall; during a morph drag the gesture already holds the transaction
+        // and the host gestures for every step
+        if (!isMorphGestureActive)
+            undoManager.beginNewTransaction();
+
+        const std::array<std::pair<juce::AudioParameterFloat*, float>, 5> values{ {
+            { size, snapshot.size },
+            { mix, snapshot.mix },
+            { width, snapshot.width },
+            { damp, snapshot.damp },
+            { freeze, snapshot.freeze }
+        } };
+
+        for (const auto& [parameter, value] : values)
+        {
+            if (!isMorphGestureActive)
+                parameter->beginChangeGesture();
+
+            *parameter = value;
+
+            if (!isMorphGestureActive)
+                parameter->endChangeGesture();
+        }
     }
 
-    void ThreeDVerbAudioProcessor::setEnvFollowerParams(juce::dsp::BallisticsFilter<float> envFollower)
-    {  
-        envFollower.setAttackTime(200.f);
-        envFollower.setReleaseTime(200.f);
-        envFollower.setLevelCalculationType(
-            juce::dsp::BallisticsFilter<float>::LevelCalculationType::peak);
+    void ThreeDVerbAudioProcessor::beginMorphGesture()
+    {
+        if (isMorphGestureActive)
+            finishMorphGesture();
+
+        undoManager.beginNewTransaction();
+
+        for (auto* parameter : getSnapshotParameters())
+            parameter->beginChangeGesture();
+
+        isMorphGestureActive = true;
+    }
+
+    // the last morph step is usually still on its way through the audio thread; timerCallback()
+    // finishes the gesture once it has been synced
+    void ThreeDVerbAudioProcessor::endMorphGesture()
+    {
+        isMorphGestureEnding = isMorphGestureActive;
+    }
+
+    void ThreeDVerbAudioProcessor::finishMorphGesture()
+    {
+        for (auto* parameter : getSnapshotParameters())
+            parameter->endChangeGesture();
+
+        isMorphGestureActive = false;
+        isMorphGestureEnding = false;
     }
 
     void ThreeDVerbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
     {
+        TDV_TRACE_SCOPE("processBlock");
         juce::ScopedNoDenormals noDenormals;
         // clears empty output channels 
         auto totalInputChannels = getTotalNumInputChannels();
@@ -218,61 +563,217 @@ namespace webview_plugin
             buffer.clear(i, 0, buffer.getNumSamples());
         }
 
-        if (bypass.get()) { return; }
+        lastBlockMs = juce::Time::getMillisecondCounter();
 
-        if (mono.get() && totalInputChannels >= 2)
+        if (bypass.get())
         {
-            sumLeftAndRightChannels(buffer);
+            // keep the queue drained and take snapshot requests so changes made while bypassed are in
+            // place when processing resumes. Nothing is audible, so a recall switches without a crossfade
+            // and a crossfade that was running is dropped
+            collectParameterChanges();
+            finishRamp();
+            fadingReverb = nullptr;
+            applyPendingSnapshot(false);
+            return;
         }
-        
-        auto nextGainVal = smoothedGain.getNextValue();
-        buffer.applyGain(nextGainVal);
+
+        const auto sumToMono = mono.get() && totalInputChannels >= 2;
+        const auto withAnalysis = analysisEnabled.load();
+
+        // the mono path needs its own wet level; see setReverbParameters(). In mono juce::dsp::Reverb only
+        // runs its left tank, so the right one still holds whatever it had when stereo last ran: fade to the
+        // other, empty reverb rather than play that back. During a snapshot crossfade the incoming reverb
+        // was reset less than snapshotCrossfadeSeconds ago, so it just switches
+        if (sumToMono != reverbIsMono)
+        {
+            if (fadingReverb == nullptr)
+                startCrossfade();
+
+            reverbIsMono = sumToMono;
+            setReverbParameters(*reverb);
+        }
+
+        collectParameterChanges();
+        applyPendingSnapshot(true);
 
         juce::dsp::AudioBlock<float> block{ buffer };
-        juce::dsp::AudioBlock<float> envOutBlock{ envelopeFollowerOutputBuffer };
 
-        juce::dsp::ProcessContextNonReplacing<float> envCtx{ block, envOutBlock };
-        envelopeFollower.process(envCtx);
+        // decide once per block; freeze needs no variant since it only changes juce::dsp::Reverb's internal gains
+        if (sumToMono)
+            withAnalysis ? processSubBlocks<true, true>(block) : processSubBlocks<true, false>(block);
+        else
+            withAnalysis ? processSubBlocks<false, true>(block) : processSubBlocks<false, false>(block);
 
-        updateReverb();
-        juce::dsp::ProcessContextReplacing<float> reverbCtx{block};
-        reverb.process(reverbCtx);
+        setParamsForFrontend();
+    }
+
+    // audio thread, at the start of a block; sets up the ramp from the current values to the newest queued ones
+    void ThreeDVerbAudioProcessor::collectParameterChanges()
+    {
+        rampStart = getParamsAsSnapshot();
+        rampEnd = rampStart;
+
+        ParameterEvent event;
+
+        if (parameterEventsDropped.exchange(false))
+        {
+            // the queue overflowed, so the newest changes are missing; ramp to what the parameters hold now
+            for (size_t i = 0; i < ParameterEventQueue::capacity && parameterEvents.pop(event); ++i) {}
+            rampEnd = getCurrentSnapshot();
+        }
+        else
+        {
+            // only the newest value of each parameter matters
+            for (size_t i = 0; i < ParameterEventQueue::capacity && parameterEvents.pop(event); ++i)
+                applyParameterEvent(event, rampEnd);
+        }
+
+        // freeze switches at the start of the block; ramping it would pass through partial feedback
+        if (rampEnd.freeze != rampStart.freeze)
+        {
+            rampStart.freeze = rampEnd.freeze;
+            applySnapshotToParams(rampStart);
+            setReverbParameters(*reverb);
+        }
+
+        isRamping = rampEnd.size != rampStart.size
+            || rampEnd.mix != rampStart.mix
+            || rampEnd.width != rampStart.width
+            || rampEnd.damp != rampStart.damp;
+    }
+
+    // lands exactly on the ramp's target
+    void ThreeDVerbAudioProcessor::finishRamp()
+    {
+        if (!isRamping)
+            return;
 
-        prepareForFFT(block);
-        
-        setParamsForFrontend(envOutBlock);
+        applySnapshotToParams(rampEnd);
+        setReverbParameters(*reverb);
+        isRamping = false;
     }
 
-    void ThreeDVerbAudioProcessor::sumLeftAndRightChannels(juce::AudioBuffer<float>& buffer)
+    ReverbSnapshot ThreeDVerbAudioProcessor::getParamsAsSnapshot() const
     {
-        auto* monoInput = buffer.getReadPointer(0);
-        auto* leftOut = buffer.getWritePointer(0);
-        auto* rightOut = buffer.getWritePointer(1);
+        return { params.roomSize, params.wetLevel, params.width, params.damping, params.freezeMode };
+    }
+
+    void ThreeDVerbAudioProcessor::applyParameterEvent(const ParameterEvent& event, ReverbSnapshot& target)
+    {
+        switch (event.parameter)
+        {
+            case sizeParameter: target.size = event.value; break;
+            case mixParameter: target.mix = event.value; break;
+            case widthParameter: target.width = event.value; break;
+            case dampParameter: target.damp = event.value; break;
+            case freezeParameter: target.freeze = event.value; break;
+            default: jassertfalse; break;
+        }
+    }
+
+    // hosts may send anything from a few samples to several thousand (offline bounce);
+    // slice into fixed sub-blocks so the working set and cost per sample stay the same.
+    // While a parameter changed this block, each sub-block moves it one step closer to its new
+    // value (juce::dsp::Reverb smooths within the steps), reaching it on the last sub-block
+    template <bool isMono, bool withAnalysis>
+    void ThreeDVerbAudioProcessor::processSubBlocks(juce::dsp::AudioBlock<float> block)
+    {
+        const auto numSamples = block.getNumSamples();
+        const auto numSubBlocks = (numSamples + subBlockSize - 1) / subBlockSize;
+        size_t subBlockIndex = 0;
+
+        for (size_t start = 0; start < numSamples; start += subBlockSize)
+        {
+            if (isRamping)
+            {
+                const auto amount = static_cast<float>(++subBlockIndex) / static_cast<float>(numSubBlocks);
+                applySnapshotToParams(SnapshotBank::interpolate(rampStart, rampEnd, amount));
+                setReverbParameters(*reverb);
+            }
+
+            processSubBlock<isMono, withAnalysis>(block.getSubBlock(start, juce::jmin(subBlockSize, numSamples - start)));
+        }
+
+        finishRamp();
+    }
+
+    // block is at most subBlockSize samples long
+    template <bool isMono, bool withAnalysis>
+    void ThreeDVerbAudioProcessor::processSubBlock(juce::dsp::AudioBlock<float> block)
+    {
+        // in mono everything below runs on channel 0 only (juce::dsp::Reverb takes its mono path);
+        // channel 1 becomes a copy of the result at the end
+        auto dspBlock = block;
+        if constexpr (isMono)
+        {
+            sumLeftAndRightChannels(block);
+            dspBlock = block.getSingleChannelBlock(0);
+        }
+
+        applySmoothedGain(dspBlock);
+
+        // during a crossfade the outgoing reverb runs on a copy of the same input
+        if (fadingReverb != nullptr)
+        {
+            processFadingReverb(dspBlock);
+        }
+
+        juce::dsp::ProcessContextReplacing<float> reverbCtx{ dspBlock };
+        reverb->process(reverbCtx);
+
+        if (fadingReverb != nullptr)
+        {
+            crossfadeFromFadingReverb(dspBlock);
+        }
+
+        // only a copy into the analysis ring happens here; see AnalysisThread
+        if constexpr (withAnalysis)
+        {
+            analysis.push(dspBlock);
+        }
 
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        if constexpr (isMono)
         {
-            leftOut[i] = monoInput[i];
-            rightOut[i] = monoInput[i];
-        }    
+            block.getSingleChannelBlock(1).copyFrom(dspBlock);
+        }
     }
 
-    void ThreeDVerbAudioProcessor::prepareForFFT(juce::dsp::AudioBlock<float> block)
+    void ThreeDVerbAudioProcessor::applySmoothedGain(juce::dsp::AudioBlock<float> block)
     {
-        for (auto i = 0; i < block.getNumSamples(); ++i)
+        const auto numSamples = static_cast<int>(block.getNumSamples());
+
+        if (!smoothedGain.isSmoothing())
+        {
+            if (const auto gainValue = smoothedGain.getCurrentValue(); gainValue != 1.0f)
+                block.multiplyBy(gainValue);
+            return;
+        }
+
+        // per-sample ramp while the gain is moving, applied to each channel with a vectorized multiply
+        for (int i = 0; i < numSamples; ++i)
         {
-            // average L + R stereo samples into single sample
-            float monoSample = 0.5f * (block.getChannelPointer(0)[i] + block.getChannelPointer(1)[i]);
-            // push sample into an array so that a set block of samples 
-            // can be processed by FFT algorithm. FFT transforms time domain to frequency domain.
-            // Frequency data are gathered in "freq bins" that represent magnitudes
-            // of a given freq. over the duration of the block
-            fifo.push(monoSample);
+            gainRamp[(size_t)i] = smoothedGain.getNextValue();
         }
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            juce::FloatVectorOperations::multiply(block.getChannelPointer(channel), gainRamp.data(), numSamples);
+        }
+    }
+
+    // writes (L + R) / 2 into channel 0; channel 1 is left for processSubBlock() to overwrite
+    void ThreeDVerbAudioProcessor::sumLeftAndRightChannels(juce::dsp::AudioBlock<float> block)
+    {
+        auto* left = block.getChannelPointer(0);
+        const auto* right = block.getChannelPointer(1);
+        const auto numSamples = static_cast<int>(block.getNumSamples());
+
+        juce::FloatVectorOperations::add(left, right, numSamples);
+        juce::FloatVectorOperations::multiply(left, 0.5f, numSamples);
     }
 
-    void ThreeDVerbAudioProcessor::setParamsForFrontend(juce::dsp::AudioBlock<float> envOutBlock)
+    void ThreeDVerbAudioProcessor::setParamsForFrontend()
     {
-        outputLevelLeft = juce::Decibels::gainToDecibels(envOutBlock.getSample(0u, static_cast<int>(envOutBlock.getNumSamples() - 1)));
         isFrozen = params.freezeMode > 0.5f;
         mixValue = params.wetLevel;
         roomSizeValue = params.roomSize;
@@ -298,7 +799,9 @@ namespace webview_plugin
         // You could do that either as raw data, or use the XML or ValueTree classes
         // as intermediaries to make it easy to save and load complex data.
         juce::MemoryOutputStream mos(destData, true);
-        apvts.state.writeToStream(mos);
+        auto state = apvts.copyState();
+        state.appendChild(snapshots.toValueTree(), nullptr);
+        state.writeToStream(mos);
     }
 
     void ThreeDVerbAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
@@ -308,14 +811,37 @@ namespace webview_plugin
         auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
         if (tree.isValid())
         {
+            // snapshots are stored beside the parameters; keep them out of the APVTS state
+            const auto snapshotTree = tree.getChildWithName(SnapshotBank::treeType);
+            snapshots.fromValueTree(snapshotTree);
+            tree.removeChild(snapshotTree, nullptr);
+
+            // replaceState() notifies parameterChanged(), which queues the new values for the audio thread
             apvts.replaceState(tree);
-            updateReverb();
         }
     }
 
+    // may be called on any thread, including the audio thread (host automation)
     void ThreeDVerbAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
     {
-        smoothedGain.setTargetValue(newValue);
+        if (parameterID == id::GAIN.getParamID())
+        {
+            smoothedGain.setTargetValue(newValue);
+            return;
+        }
+
+        ParameterEvent event;
+        event.value = newValue;
+
+        if (parameterID == id::SIZE.getParamID())        event.parameter = sizeParameter;
+        else if (parameterID == id::MIX.getParamID())    event.parameter = mixParameter;
+        else if (parameterID == id::WIDTH.getParamID())  event.parameter = widthParameter;
+        else if (parameterID == id::DAMP.getParamID())   event.parameter = dampParameter;
+        else if (parameterID == id::FREEZE.getParamID()) event.parameter = freezeParameter;
+        else return;
+
+        if (!parameterEvents.push(event))
+            parameterEventsDropped = true;
     }
 }
     //==============================================================================
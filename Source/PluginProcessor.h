@@ -9,6 +9,11 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "Tracing.h"
+#include "Fifo.h"
+#include "AnalysisThread.h"
+#include "ParameterEventQueue.h"
+#include "SnapshotBank.h"
 
 //==============================================================================
 /**
@@ -16,84 +21,8 @@
 namespace webview_plugin
 {
 
-    struct Fifo
-    { 
-        static constexpr auto fftOrder{ 11 };
-        static constexpr auto fftSize{ 1 << fftOrder };
-        static constexpr auto fftDataSize{ fftSize * 2 };
-        static constexpr auto scopeSize{ fftSize / 4 };
-
-        juce::dsp::FFT forwardFFT{ fftOrder };
-        juce::dsp::WindowingFunction<float> window{ fftSize, juce::dsp::WindowingFunction<float>::hann };
-        std::array<float, fftSize> samples;
-        // for holding FFT processed sample data; FFT algorithm requires double space
-        std::array<float, fftDataSize> fftSampleData; 
-        int index{ 0 };
-
-        // store normalized levels derived from fftData using applyLogarithmicFreqMapping() below
-        juce::Array<juce::var> levels;
-        juce::SpinLock levelsLock;
-
-        // processBlock() -> prepareForFFT() -> push()
-        // PluginEditor.cpp in getResource() -> const juce::SpinLock::ScopedLockType lock(audioProcessor.levelsLock)
-        // occasionally front end will hold  the lock first since JSON serialization can take microseconds or more
-        void push(float sample) noexcept
-        {
-            if (index == fftSize)
-            {
-                // copy fifo sample data into beginning of fftSampleData
-                // for intermediate calcs, fftSampleData can hold twice as much data as fifo
-                std::copy(samples.begin(), samples.end(), fftSampleData.begin());
-                // reduce spectral leakage by applying windowing function to data; make more perceptually accurate
-                window.multiplyWithWindowingTable(fftSampleData.data(), fftSize);
-                // perform FFT on fftData; only keep frequency information; only calculate non-negative frequencies;
-                forwardFFT.performFrequencyOnlyForwardTransform(fftSampleData.data(), true);
-                // for thread-safety. ScopedTryLockType automatically unlocks at end of block using RAII
-                // ScopedTryLockType "tries" to lock. If lock acquired, safe to access shared data
-                // if UI thread is busy (i.e. holding the lock) ScopedTryLockType fails to get lock; isLocked() returns false
-                // audio thread continues
-                // otherwise ScopedTryLockType gets the lock right away and isLocked() returns true =>
-                // code in if block below executes
-                // end result: achieve thread safety and don't risk audio dropping out
-                // try-lock pattern =>
-                // make sure audio thread doesn't have to wait: either succeed or fail and move on
-                juce::SpinLock::ScopedTryLockType tryLock(levelsLock);
-                if (tryLock.isLocked())
-                {
-                    levels.clearQuick();
-                    applyLogarithmicFreqMapping();
-                }
-                // else: Lock is busy, skip frame.
-
-                index = 0;
-            }
-            samples[(size_t)index++] = sample;
-        }
-
-        void applyLogarithmicFreqMapping() {
-            auto mindB = -100.0f;
-            auto maxdB = 0.0f;
-            for (int i = 0; i < scopeSize; ++i)
-            {
-                auto skewedProportionX = 1.0f - std::exp(std::log(1.0f - (float)i / (float)scopeSize) * 0.2f);
-                auto fftDataIndex = juce::jlimit(0, fftSize / 2, (int)(skewedProportionX * (float)fftSize * 0.5f));
-                auto decibelsAtIndex = juce::Decibels::gainToDecibels(fftSampleData.at(fftDataIndex));
-                auto sourceValue = juce::jlimit(mindB, maxdB, decibelsAtIndex) - juce::Decibels::gainToDecibels((float)fftSize);
-                auto level = juce::jmap(
-                    sourceValue, // sourceValue
-                    mindB, // sourceRangeMin
-                    maxdB, // sourceRangeMax
-                    0.0f,  // targetRangeMin
-                    1.0f); // targetRangeMax
-                // guarantee level between 0 and 1;
-                level = juce::jlimit(0.0f, 1.0f, level);
-                levels.add(level);
-            }
-        }
-
-    };
-
-    class ThreeDVerbAudioProcessor : public juce::AudioProcessor, public juce::AudioProcessorValueTreeState::Listener
+    class ThreeDVerbAudioProcessor : public juce::AudioProcessor, public juce::AudioProcessorValueTreeState::Listener,
+        private juce::Timer
     {
     public:
         //==============================================================================
@@ -135,30 +64,103 @@ namespace webview_plugin
         void parameterChanged(const juce::String& parameterID, float newValue) override;
 
         juce::AudioProcessorValueTreeState apvts;
-        Fifo fifo{};
+        // owns the spectrum analysers and the thread that feeds them; also publishes output level, loudness and true peak
+        AnalysisThread analysis;
 
-        std::atomic<float> outputLevelLeft;
         bool isFrozen;
         juce::var mixValue;
         juce::var roomSizeValue;
         juce::var widthValue;
         juce::var dampValue;
 
-        size_t getScopeSize() { return fifo.scopeSize; };
+        size_t getScopeSize() { return static_cast<size_t>(analysis.getSpectrum().getScopeSize()); };
+
+        // undo history cap in transactions (one per slider gesture or button press); the oldest
+        // transactions are dropped first
+        static constexpr int defaultUndoHistoryTransactions{ 200 };
+        void setUndoHistoryLimit(int maxTransactions);
+
+        // A/B and numbered snapshots; also exposed to the host as programs
+        SnapshotBank snapshots;
+        // message thread; captures the current parameter values
+        void storeSnapshot(int slot);
+        // any thread; the audio thread crossfades to the slot at its next block (while bypassed it
+        // just switches), then the parameters follow on the message thread. Empty slots are ignored
+        void recallSnapshot(int slot);
+        // any thread; 0 == A, 1 == B. Moves the parameters without a crossfade (juce::dsp::Reverb smooths them)
+        void morphSnapshots(float amount);
+        // message thread; brackets a morph drag so the host sees one gesture and undo gets one transaction
+        void beginMorphGesture();
+        void endMorphGesture();
+        static constexpr double snapshotCrossfadeSeconds{ 0.25 };
+        // with no block for this long (host stopped processing), the message thread applies
+        // snapshot requests to the parameters itself
+        static constexpr juce::uint32 audioIdleTimeoutMs{ 500 };
+
+        // message thread; the editor switches analysis on while it is open. With it off (the default)
+        // the audio thread skips the ring copies and the analysis thread isn't running
+        void setAnalysisEnabled(bool shouldBeEnabled);
+        // message thread; offline tools switch the thread off and call analysis.analysePending()
+        // after every block, so analysis stays enabled but runs deterministically on their thread
+        void setAnalysisThreadEnabled(bool shouldRunThread);
+
+        // internal processing granularity: small enough that per-block buffers stay cache resident
+        static constexpr size_t subBlockSize{ 128 };
         
     private:
         //==============================================================================
         std::atomic<float>* gain{ nullptr };
         juce::LinearSmoothedValue<float> smoothedGain;
+        std::array<float, subBlockSize> gainRamp{};
         juce::AudioParameterBool& bypass;
         juce::AudioParameterBool& mono;
-
-        juce::dsp::BallisticsFilter<float> envelopeFollower;
-        juce::AudioBuffer<float> envelopeFollowerOutputBuffer;
+        std::atomic<bool> analysisEnabled{ false };
+        // guards starting, stopping and preparing the analysis thread; never taken on the audio thread
+        juce::CriticalSection analysisLock;
+        bool isAnalysisPrepared{ false };
+        bool isAnalysisThreadEnabled{ true };
+        void updateAnalysisThread();
 
         // REVERB PARAMS
-        juce::dsp::Reverb reverb;
+        // two tanks so a snapshot recall can fade the old one out while the new one fades in;
+        // reverb is the one parameter changes go to, fadingReverb is non-null only during a crossfade
+        std::array<juce::dsp::Reverb, 2> reverbs;
+        juce::dsp::Reverb* reverb{ &reverbs[0] };
+        juce::dsp::Reverb* fadingReverb{ nullptr };
+        // the outgoing tank keeps running the way it was set up, even after a mono switch
+        bool fadingReverbIsMono{ false };
+        juce::AudioBuffer<float> crossfadeBuffer;
+        std::array<float, subBlockSize> crossfadeRamp{};
+        int crossfadeLengthSamples{ 1 };
+        int crossfadeSamplesRemaining{ 0 };
+        // owned by the audio thread; changed only through parameter events (or updateReverb())
         juce::dsp::Reverb::Parameters params;
+        // whether reverb currently runs on one channel (mono mode); its parameters are adjusted for that
+        bool reverbIsMono{ false };
+
+        // parameterChanged() queues each reverb parameter change; processBlock() ramps size, mix, width
+        // and damp from their previous values to the newest queued ones across the block's sub-blocks,
+        // so hosts that send one value per block don't step at large buffer sizes
+        enum ReverbParameter { sizeParameter, mixParameter, widthParameter, dampParameter, freezeParameter };
+        ParameterEventQueue parameterEvents;
+        std::atomic<bool> parameterEventsDropped{ false };
+        ReverbSnapshot rampStart;
+        ReverbSnapshot rampEnd;
+        bool isRamping{ false };
+
+        // snapshot requests (any thread -> audio thread) and the resulting parameter sync
+        // (audio thread -> message thread); noSnapshot / a negative morph means none pending
+        static constexpr int noSnapshot{ -1 };
+        std::atomic<int> requestedSnapshot{ noSnapshot };
+        std::atomic<float> requestedMorph{ -1.0f };
+        std::atomic<int> recalledSnapshot{ noSnapshot };
+        std::atomic<float> recalledMorph{ -1.0f };
+        // the slot the settings last came from or went to; noSnapshot before that and after a morph
+        std::atomic<int> currentSnapshot{ noSnapshot };
+        std::atomic<juce::uint32> lastBlockMs{ 0 };
+        // message thread only; the gesture ends once the last morph step has been synced
+        bool isMorphGestureActive{ false };
+        bool isMorphGestureEnding{ false };
 
         juce::AudioParameterFloat* size{ nullptr };
         juce::AudioParameterFloat* mix{ nullptr };
@@ -167,10 +169,31 @@ namespace webview_plugin
         juce::AudioParameterFloat* freeze{ nullptr };
 
         void updateReverb();
-        void setEnvFollowerParams(juce::dsp::BallisticsFilter<float> envFollower);
-        void setParamsForFrontend(juce::dsp::AudioBlock<float> envOutBlock);
-        void prepareForFFT(juce::dsp::AudioBlock<float> block);
-        void sumLeftAndRightChannels(juce::AudioBuffer<float>& buffer);
+        void setReverbParameters(juce::dsp::Reverb& target);
+        void collectParameterChanges();
+        void finishRamp();
+        ReverbSnapshot getParamsAsSnapshot() const;
+        static void applyParameterEvent(const ParameterEvent& event, ReverbSnapshot& target);
+        void applyPendingSnapshot(bool shouldCrossfade);
+        void applySnapshotToParams(const ReverbSnapshot& snapshot);
+        void startCrossfade();
+        void processFadingReverb(juce::dsp::AudioBlock<float> block);
+        void crossfadeFromFadingReverb(juce::dsp::AudioBlock<float> block);
+        ReverbSnapshot getCurrentSnapshot() const;
+        void setParametersFromSnapshot(const ReverbSnapshot& snapshot);
+        void applyRequestsWhileIdle();
+        void finishMorphGesture();
+        std::array<juce::AudioParameterFloat*, 5> getSnapshotParameters() const { return { size, mix, width, damp, freeze }; }
+        void timerCallback() override;
+        void setParamsForFrontend();
+        // specialised once per block on mono/stereo and analysis on/off so the per-sub-block
+        // code has no runtime branches on either
+        template <bool isMono, bool withAnalysis>
+        void processSubBlocks(juce::dsp::AudioBlock<float> block);
+        template <bool isMono, bool withAnalysis>
+        void processSubBlock(juce::dsp::AudioBlock<float> block);
+        void applySmoothedGain(juce::dsp::AudioBlock<float> block);
+        void sumLeftAndRightChannels(juce::dsp::AudioBlock<float> block);
 
         juce::UndoManager undoManager;
 
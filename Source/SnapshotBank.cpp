@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    Preallocated reverb parameter snapshots.
+
+  ==============================================================================
+*/
+
+#include "SnapshotBank.h"
+
+namespace webview_plugin
+{
+    namespace
+    {
+        const juce::Identifier slotType{ "SLOT" };
+        const juce::Identifier indexProperty{ "index" };
+        // same order as SnapshotBank::Slot::fields
+        const std::array<juce::Identifier, 5> fieldProperties{ "size", "mix", "width", "damp", "freeze" };
+
+        std::array<float, 5> toFields(const ReverbSnapshot& snapshot) noexcept
+        {
+            return { snapshot.size, snapshot.mix, snapshot.width, snapshot.damp, snapshot.freeze };
+        }
+
+        ReverbSnapshot fromFields(const std::array<float, 5>& fields) noexcept
+        {
+            return { fields[0], fields[1], fields[2], fields[3], fields[4] };
+        }
+    }
+
+    const juce::Identifier SnapshotBank::treeType{ "SNAPSHOTS" };
+
+    juce::String SnapshotBank::getSlotName(int slot)
+    {
+        if (slot == slotA) return "A";
+        if (slot == slotB) return "B";
+        return juce::String(slot - 1);
+    }
+
+    void SnapshotBank::store(int slot, const ReverbSnapshot& snapshot) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(slot, numSlots));
+        auto& s = slots[(size_t)slot];
+        const auto fields = toFields(snapshot);
+
+        const auto sequence = s.sequence.load(std::memory_order_relaxed);
+        s.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < numFields; ++i)
+            s.fields[i].store(fields[i], std::memory_order_relaxed);
+
+        s.sequence.store(sequence + 2, std::memory_order_release);
+        s.stored.store(true, std::memory_order_release);
+    }
+
+    bool SnapshotBank::load(int slot, ReverbSnapshot& snapshot) const noexcept
+    {
+        if (!isStored(slot))
+            return false;
+
+        const auto& s = slots[(size_t)slot];
+
+        // the writer only holds the slot for a few stores; if it keeps losing the race, give up
+        // rather than spin on the audio thread
+        for (int attempt = 0; attempt < 16; ++attempt)
+        {
+            const auto before = s.sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                continue;
+
+            std::array<float, numFields> fields{};
+            for (size_t i = 0; i < numFields; ++i)
+                fields[i] = s.fields[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (s.sequence.load(std::memory_order_relaxed) == before)
+            {
+                snapshot = fromFields(fields);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool SnapshotBank::isStored(int slot) const noexcept
+    {
+        return juce::isPositiveAndBelow(slot, numSlots) && slots[(size_t)slot].stored.load(std::memory_order_acquire);
+    }
+
+    ReverbSnapshot SnapshotBank::interpolate(const ReverbSnapshot& a, const ReverbSnapshot& b, float amount) noexcept
+    {
+        const auto lerp = [amount](float from, float to) { return from + (to - from) * amount; };
+
+        return { lerp(a.size, b.size),
+                 lerp(a.mix, b.mix),
+                 lerp(a.width, b.width),
+                 lerp(a.damp, b.damp),
+                 amount < 0.5f ? a.freeze : b.freeze };
+    }
+
+    juce::ValueTree SnapshotBank::toValueTree() const
+    {
+        juce::ValueTree tree{ treeType };
+
+        for (int slot = 0; slot < numSlots; ++slot)
+        {
+            ReverbSnapshot snapshot;
+            if (!load(slot, snapshot))
+                continue;
+
+            juce::ValueTree slotTree{ slotType };
+            slotTree.setProperty(indexProperty, slot, nullptr);
+
+            const auto fields = toFields(snapshot);
+            for (size_t i = 0; i < numFields; ++i)
+                slotTree.setProperty(fieldProperties[i], fields[i], nullptr);
+
+            tree.appendChild(slotTree, nullptr);
+        }
+
+        return tree;
+    }
+
+    void SnapshotBank::fromValueTree(const juce::ValueTree& tree)
+    {
+        for (auto& s : slots)
+            s.stored.store(false, std::memory_order_release);
+
+        for (const auto& slotTree : tree)
+        {
+            const auto slot = static_cast<int>(slotTree.getProperty(indexProperty, -1));
+            if (!slotTree.hasType(slotType) || !juce::isPositiveAndBelow(slot, numSlots))
+                continue;
+
+            const auto defaults = toFields(ReverbSnapshot{});
+            std::array<float, numFields> fields{};
+            for (size_t i = 0; i < numFields; ++i)
+                fields[i] = static_cast<float>(slotTree.getProperty(fieldProperties[i], defaults[i]));
+
+            store(slot, fromFields(fields));
+        }
+    }
+}
@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    Preallocated reverb parameter snapshots: A, B and numbered slots.
+
+    Slots are written from the message thread and read on the audio thread;
+    both sides only touch atomics, so recall and morph need no allocation,
+    locking or ValueTree work during playback.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace webview_plugin
+{
+    // plain parameter values (the same 0..1 values the APVTS holds)
+    struct ReverbSnapshot
+    {
+        float size{ 0.5f };
+        float mix{ 0.75f };
+        float width{ 0.75f };
+        float damp{ 0.5f };
+        float freeze{ 0.0f };
+    };
+
+    class SnapshotBank
+    {
+    public:
+        static constexpr int slotA{ 0 };
+        static constexpr int slotB{ 1 };
+        static constexpr int numNumberedSlots{ 8 };
+        static constexpr int numSlots{ 2 + numNumberedSlots };
+
+        // "A", "B", "1" .. "8"
+        static juce::String getSlotName(int slot);
+
+        // any thread; a single writer at a time (the message thread)
+        void store(int slot, const ReverbSnapshot& snapshot) noexcept;
+        // any thread; returns false (and leaves snapshot alone) if the slot is empty
+        bool load(int slot, ReverbSnapshot& snapshot) const noexcept;
+        bool isStored(int slot) const noexcept;
+
+        // amount 0 == a, 1 == b; freeze switches halfway
+        static ReverbSnapshot interpolate(const ReverbSnapshot& a, const ReverbSnapshot& b, float amount) noexcept;
+
+        // message thread; persisted as a child of the plugin state
+        static const juce::Identifier treeType;
+        juce::ValueTree toValueTree() const;
+        void fromValueTree(const juce::ValueTree& tree);
+
+    private:
+        static constexpr size_t numFields{ 5 };
+
+        // seqlock: the writer makes the sequence odd while it updates the fields,
+        // so a reader that raced it sees a changed or odd sequence and retries
+        struct Slot
+        {
+            std::atomic<juce::uint32> sequence{ 0 };
+            std::array<std::atomic<float>, numFields> fields{};
+            std::atomic<bool> stored{ false };
+        };
+
+        std::array<Slot, numSlots> slots;
+    };
+}
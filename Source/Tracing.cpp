@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    Low-overhead span tracing for the audio, analysis and message threads.
+
+  ==============================================================================
+*/
+
+#include "Tracing.h"
+
+namespace webview_plugin::tracing
+{
+    Tracer& Tracer::getInstance()
+    {
+        // shared by every plugin instance in the process so one dump shows all of them
+        static Tracer instance;
+        return instance;
+    }
+
+    void Tracer::setEnabled(bool shouldBeEnabled)
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+
+        if (shouldBeEnabled && !allocated.load())
+        {
+            for (auto& buffer : buffers)
+                buffer = std::make_unique<ThreadBuffer>();
+
+            allocated.store(true);
+        }
+
+        const auto wasEnabled = enabled.load();
+
+        // a new session starts with empty rings; nothing writes while disabled, and switching off
+        // already waited for the last writes of the previous session
+        if (shouldBeEnabled && !wasEnabled)
+            for (auto& buffer : buffers)
+                buffer->writeIndex.store(0);
+
+        enabled.store(shouldBeEnabled);
+
+        // record() re-checks enabled before writing, but a writer that passed that check just before
+        // we switched off may still be storing its span; give it time to finish before the rings are
+        // read or reset. A writer preempted for longer than this can still leave one torn entry
+        if (wasEnabled && !shouldBeEnabled)
+            juce::Thread::sleep(spanGracePeriodMs);
+    }
+
+    void Tracer::record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept
+    {
+        // spans that were still open when tracing was switched off are dropped
+        if (!isEnabled())
+            return;
+
+        if (auto* buffer = getBufferForThisThread())
+            buffer->record(name, startTicks, endTicks);
+    }
+
+    void Tracer::recordInstant(const char* name) noexcept
+    {
+        if (!isEnabled())
+            return;
+
+        if (auto* buffer = getBufferForThisThread())
+        {
+            const auto ticks = juce::Time::getHighResolutionTicks();
+            buffer->record(name, ticks, ticks, true);
+        }
+    }
+
+    ThreadBuffer* Tracer::getBufferForThisThread() noexcept
+    {
+        // hands the buffer back when the thread ends, so threads that come and go (the analysis
+        // thread restarts with every editor and prepareToPlay(), hosts run worker pools) don't use
+        // up the slots. Buffers are never freed once allocated, so the pointer stays valid
+        struct BufferOwner
+        {
+            ~BufferOwner()
+            {
+                if (buffer != nullptr)
+                    buffer->inUse.store(false, std::memory_order_release);
+            }
+
+            ThreadBuffer* buffer{ nullptr };
+        };
+
+        thread_local BufferOwner owner;
+
+        if (owner.buffer != nullptr || !allocated.load(std::memory_order_acquire))
+            return owner.buffer;
+
+        owner.buffer = claimBuffer();
+        return owner.buffer;
+    }
+
+    ThreadBuffer* Tracer::claimBuffer() noexcept
+    {
+        // never-claimed buffers first, so spans of threads that have ended survive as long as possible
+        for (const auto reuseEndedThreads : { false, true })
+        {
+            for (auto& buffer : buffers)
+            {
+                if ((buffer->threadId != 0) != reuseEndedThreads)
+                    continue;
+
+                auto expected = false;
+                if (!buffer->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                    continue;
+
+                // an ended thread's spans would be attributed to this one, so drop them
+                buffer->writeIndex.store(0, std::memory_order_relaxed);
+                buffer->threadId = (juce::int64)(juce::pointer_sized_int)juce::Thread::getCurrentThreadId();
+                buffer->threadName = {};
+                buffer->threadRole = "";
+
+                if (auto* thread = juce::Thread::getCurrentThread())
+                    buffer->threadName = thread->getThreadName(); // ref-counted copy, no allocation
+                else if (juce::MessageManager::existsAndIsCurrentThread())
+                    buffer->threadRole = "message";
+                else
+                    buffer->threadRole = "host"; // usually the host's audio thread
+
+                return buffer.get();
+            }
+        }
+
+        return nullptr; // maxThreads threads alive at once: this one is not traced
+    }
+
+    juce::File Tracer::getDefaultTraceFile()
+    {
+        return juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+            .getChildFile("3DVerb_trace_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S") + ".json");
+    }
+
+    juce::Result Tracer::writeChromeTrace(const juce::File& file)
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+
+        // stop recording first; setEnabled(false) waits for spans that were mid-write
+        setEnabled(false);
+
+        if (!allocated.load())
+            return juce::Result::fail("tracing was never enabled");
+
+        // timestamps in the file are relative to the earliest recorded span
+        auto earliestTicks = std::numeric_limits<juce::int64>::max();
+        auto forEachEvent = [&](auto&& callback)
+        {
+            for (const auto& claimed : buffers)
+            {
+                const auto& buffer = *claimed;
+                if (buffer.threadId == 0)
+                    continue;
+
+                const auto end = buffer.writeIndex.load(std::memory_order_acquire);
+                const auto begin = end > (juce::uint64)ThreadBuffer::capacity ? end - ThreadBuffer::capacity : 0;
+
+                for (auto i = begin; i < end; ++i)
+                    callback(buffer, buffer.events[i & (ThreadBuffer::capacity - 1)]);
+            }
+        };
+
+        forEachEvent([&](const ThreadBuffer&, const Event& event)
+        {
+            earliestTicks = juce::jmin(earliestTicks, event.startTicks);
+        });
+
+        auto ticksToMicroseconds = [](juce::int64 ticks)
+        {
+            return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+        };
+
+        juce::MemoryOutputStream json;
+        json << "{\"traceEvents\":[\n";
+        auto first = true;
+
+        auto separator = [&]() -> const char*
+        {
+            if (first)
+            {
+                first = false;
+                return "";
+            }
+            return ",\n";
+        };
+
+        // metadata events name each thread's row in the timeline
+        for (const auto& claimed : buffers)
+        {
+            const auto& buffer = *claimed;
+            if (buffer.threadId == 0)
+                continue;
+
+            const auto name = buffer.threadName.isNotEmpty() ? buffer.threadName : juce::String(buffer.threadRole);
+            json << separator()
+                 << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.threadId
+                 << ",\"args\":{\"name\":" << juce::JSON::toString(name) << "}}";
+        }
+
+        forEachEvent([&](const ThreadBuffer& buffer, const Event& event)
+        {
+            json << separator()
+                 << "{\"name\":\"" << event.name << "\",\"cat\":\"3DVerb\",\"pid\":1"
+                 << ",\"tid\":" << buffer.threadId
+                 << ",\"ts\":" << juce::String(ticksToMicroseconds(event.startTicks - earliestTicks), 3);
+
+            // instant events show as a marker on the thread's row
+            if (event.isInstant)
+                json << ",\"ph\":\"i\",\"s\":\"t\"}";
+            else
+                json << ",\"ph\":\"X\",\"dur\":" << juce::String(ticksToMicroseconds(event.endTicks - event.startTicks), 3) << "}";
+        });
+
+        json << "\n]}\n";
+
+        if (!file.replaceWithData(json.getData(), json.getDataSize()))
+            return juce::Result::fail("could not write " + file.getFullPathName());
+
+        return juce::Result::ok();
+    }
+}
@@ -0,0 +1,110 @@
+/*
+  ==============================================================================
+
+    Low-overhead span tracing for the audio, analysis and message threads.
+
+    Each thread records into its own preallocated ring buffer without locking.
+    Dump with writeChromeTrace() and open the file in chrome://tracing or
+    https://ui.perfetto.dev to see a timeline of all threads.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace webview_plugin::tracing
+{
+    struct Event
+    {
+        const char* name{ nullptr };
+        juce::int64 startTicks{ 0 };
+        juce::int64 endTicks{ 0 };
+        // a point in time (e.g. a skipped frame) rather than a span; endTicks == startTicks
+        bool isInstant{ false };
+    };
+
+    // written only by the thread that claimed it; read by writeChromeTrace()
+    struct ThreadBuffer
+    {
+        static constexpr auto capacity{ 1 << 13 };
+
+        void record(const char* name, juce::int64 startTicks, juce::int64 endTicks, bool isInstant = false) noexcept
+        {
+            const auto index = writeIndex.load(std::memory_order_relaxed);
+            // ring buffer: oldest events are overwritten so the end of a problem session is kept
+            events[index & (capacity - 1)] = { name, startTicks, endTicks, isInstant };
+            writeIndex.store(index + 1, std::memory_order_release);
+        }
+
+        std::array<Event, capacity> events;
+        std::atomic<juce::uint64> writeIndex{ 0 };
+        // true while the owning thread is alive; a thread hands its buffer back when it ends
+        std::atomic<bool> inUse{ false };
+        // 0 == never claimed
+        juce::int64 threadId{ 0 };
+        // juce::Thread name if there is one, otherwise a fixed role ("message", "host")
+        juce::String threadName;
+        const char* threadRole{ "" };
+    };
+
+    class Tracer
+    {
+    public:
+        static Tracer& getInstance();
+
+        // call from the message thread; buffers are allocated on first enable, never on the audio thread
+        void setEnabled(bool shouldBeEnabled);
+        bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+        void record(const char* name, juce::int64 startTicks, juce::int64 endTicks) noexcept;
+        void recordInstant(const char* name) noexcept;
+
+        // disables tracing, then writes every recorded span as Chrome trace-event JSON
+        juce::Result writeChromeTrace(const juce::File& file);
+        static juce::File getDefaultTraceFile();
+
+    private:
+        Tracer() = default;
+
+        ThreadBuffer* getBufferForThisThread() noexcept;
+        ThreadBuffer* claimBuffer() noexcept;
+
+        // a ring write takes nanoseconds; this is how long switching off waits for writes in flight
+        static constexpr auto spanGracePeriodMs{ 10 };
+        static constexpr auto maxThreads{ 32 };
+        std::array<std::unique_ptr<ThreadBuffer>, maxThreads> buffers;
+        std::atomic<bool> allocated{ false };
+        std::atomic<bool> enabled{ false };
+
+        JUCE_DECLARE_NON_COPYABLE(Tracer)
+    };
+
+    // RAII span; costs one relaxed atomic load when tracing is disabled
+    class ScopedTrace
+    {
+    public:
+        explicit ScopedTrace(const char* spanName) noexcept
+            : name(spanName),
+            startTicks(Tracer::getInstance().isEnabled() ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~ScopedTrace() noexcept
+        {
+            if (startTicks != 0)
+                Tracer::getInstance().record(name, startTicks, juce::Time::getHighResolutionTicks());
+        }
+
+    private:
+        const char* name;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedTrace)
+    };
+}
+
+// name must be a string literal (only the pointer is stored)
+#define TDV_TRACE_SCOPE(name) const webview_plugin::tracing::ScopedTrace JUCE_JOIN_MACRO(tdvTrace_, __LINE__){ name }
+#define TDV_TRACE_INSTANT(name) webview_plugin::tracing::Tracer::getInstance().recordInstant(name)
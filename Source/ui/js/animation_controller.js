@@ -45,6 +45,9 @@ export default class AnimationController {
     #environmentMap;
     #alphaMap;
 
+    #frameTimeListener = null;
+    #lastFrameTime = null;
+
     #visualParams;
     #nebulaParams;
     #nebulaSystem;
@@ -75,6 +78,11 @@ export default class AnimationController {
     }
 
     animate(time, theta = 4, emitterRadius = 16) {
+        if (this.#lastFrameTime !== null && this.#frameTimeListener) {
+            this.#frameTimeListener(time - this.#lastFrameTime);
+        }
+        this.#lastFrameTime = time;
+
         time *= 0.001;
         if (!this.#bypassIsChecked()) {
             this.#rotateSpheres(time);
@@ -88,6 +96,11 @@ export default class AnimationController {
         requestAnimationFrame((time) => this.animate(time, theta, emitterRadius));
     }
 
+    // called every frame with the time since the previous frame in ms
+    set frameTimeListener(listener) {
+        this.#frameTimeListener = listener;
+    }
+
     get envMapSubDirectories() {
         return this.#environmentMapSubDirectories;
     }
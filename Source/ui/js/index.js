@@ -13,11 +13,29 @@ let animationController;
 
 const undoButton = document.getElementById("undoButton");
 const redoButton = document.getElementById("redoButton");
+// in slot order: A, B, then 1 to 8
+const snapshotButtons = [
+    document.getElementById("snapshotAButton"),
+    document.getElementById("snapshotBButton"),
+    ...document.querySelectorAll("#snapshotSlots button"),
+];
+const snapshotMorphSlider = document.getElementById("snapshotMorphSlider");
 const envMapDropDown = document.getElementById("envMaps");
+const loudnessElements = {
+    momentary: document.getElementById("momentaryLoudnessValue"),
+    shortTerm: document.getElementById("shortTermLoudnessValue"),
+    truePeak: document.getElementById("truePeakValue"),
+}
 const undoRedoCtrl = Juce.getNativeFunction("webUndoRedo");
+const tracingCtrl = Juce.getNativeFunction("webTracing");
+const frameTimesCtrl = Juce.getNativeFunction("webFrameTimes");
+const snapshotCtrl = Juce.getNativeFunction("webSnapshot");
+// frames per webFrameTimes report (~0.5 s at 60 fps)
+const FRAMES_PER_REPORT = 30;
+let tracingEnabled = false;
 
 let roomSizeThrottleHandler, mixThrottleHandler, widthThrottleHandler, dampThrottleHandler,
-    freezeThrottleHandler, levelsThrottleHandler, outputThrottleHandler;
+    freezeThrottleHandler, levelsThrottleHandler, outputThrottleHandler, loudnessThrottleHandler;
 
 let countForParticleWave = 0;
 
@@ -71,6 +89,7 @@ document.addEventListener("DOMContentLoaded", () => {
     setupBackendEventListeners();
 
     animationController = new AnimationController();
+    animationController.frameTimeListener = createFrameTimeReporter();
     requestAnimationFrame(animationController.animate);
 });
 
@@ -85,6 +104,16 @@ function setupBackendEventListeners() {
             .catch(console.error);
     });
 
+    // LOUDNESS EVENT (BS.1770 momentary / short-term LUFS and true peak of the wet output)
+    window.__JUCE__.backend.addEventListener("loudness", () => {
+        fetch(Juce.getBackendResourceAddress("loudness.json"))
+            .then((response) => response.json())
+            .then((loudnessData) => {
+                loudnessThrottleHandler(loudnessData.loudness);
+            })
+            .catch(console.error);
+    });
+
     // ROOM SIZE
     window.__JUCE__.backend.addEventListener("roomSizeValue", () => {
         fetch(Juce.getBackendResourceAddress("roomSize.json"))
@@ -159,6 +188,27 @@ function setupBackendEventListeners() {
     })
 }
 
+// batches frame times and reports them to PluginEditor::webFrameTimes(),
+// which adapts the publish rate, bin count and FFT overlap to the frame budget
+function createFrameTimeReporter() {
+    let frameCount = 0;
+    let totalFrameTime = 0;
+    let worstFrameTime = 0;
+
+    return (frameTime) => {
+        frameCount++;
+        totalFrameTime += frameTime;
+        worstFrameTime = Math.max(worstFrameTime, frameTime);
+
+        if (frameCount === FRAMES_PER_REPORT) {
+            frameTimesCtrl(totalFrameTime / frameCount, worstFrameTime);
+            frameCount = 0;
+            totalFrameTime = 0;
+            worstFrameTime = 0;
+        }
+    }
+}
+
 function onLevelsChange(levels) {
     // send updated magnitudes to particle animation function
     if (bypassAndMono.bypass.element.checked) { return; }
@@ -181,6 +231,12 @@ function onOutputChange(output) {
     animationController.nebulaSystem.handleOutputChange(avgAmplitude, currentOutput, animationController.surroundingCube);
 }
 
+function onLoudnessChange(loudness) {
+    loudnessElements.momentary.textContent = loudness.momentary.toFixed(1) + " LUFS";
+    loudnessElements.shortTerm.textContent = loudness.shortTerm.toFixed(1) + " LUFS";
+    loudnessElements.truePeak.textContent = loudness.truePeak.toFixed(1) + " dBTP";
+}
+
 function onRoomSizeChange(roomSizeValue) {
     animationController.visualParams.currentSize = roomSizeValue;
 
@@ -240,6 +296,9 @@ function initThrottleHandlers() {
     outputThrottleHandler = Utility.throttle((output) => {
         onOutputChange(output);
     }, Utility.THROTTLE_TIME);
+    loudnessThrottleHandler = Utility.throttle((loudness) => {
+        onLoudnessChange(loudness);
+    }, Utility.THROTTLE_TIME);
 }
 
 function setupDOMEventListeners() {
@@ -263,6 +322,13 @@ function setupDOMEventListeners() {
                 console.log(result);
             });
         }
+        // calls PluginEditor::webTracing(); first press starts tracing, second press writes the trace file
+        else if (event.ctrlKey && event.shiftKey && event.key === 'T') {
+            tracingEnabled = !tracingEnabled;
+            tracingCtrl(tracingEnabled).then((result) => {
+                console.log(result);
+            });
+        }
     });
     // UNDO-REDO
     undoButton.addEventListener("click", () => {
@@ -271,6 +337,30 @@ function setupDOMEventListeners() {
     redoButton.addEventListener("click", () => {
         window.__JUCE__.backend.emitEvent("redoRequest", null);
     })
+    // SNAPSHOTS
+    // calls PluginEditor::webSnapshot(); slot 0 == A, slot 1 == B, slots 2.. == 1..
+    snapshotButtons.forEach((button, slot) => {
+        button.addEventListener("click", (event) => {
+            snapshotCtrl(event.shiftKey ? "store" : "recall", slot).then((result) => {
+                console.log(result);
+            });
+        });
+    });
+    // a drag is one gesture, so the host and undo see it as a single change
+    let isMorphing = false;
+    snapshotMorphSlider.oninput = function () {
+        if (!isMorphing) {
+            snapshotCtrl("morphStart");
+            isMorphing = true;
+        }
+        snapshotCtrl("morph", parseFloat(this.value));
+    };
+    snapshotMorphSlider.onchange = function () {
+        if (isMorphing) {
+            snapshotCtrl("morphEnd");
+            isMorphing = false;
+        }
+    };
     // BYPASS
     bypassAndMono.bypass.element.oninput = function () {
         bypassAndMono.bypass.state.setValue(this.checked);
@@ -300,7 +390,10 @@ function setupDOMEventListeners() {
     // toggle cpp backend float value based on html checked value
     // value > 0.5 == freeze mode; value < 0.5 == normal mode
     freezeCheckbox.oninput = function () {
+        // one click == one undo step
+        freeze.state.sliderDragStarted();
         freeze.state.setNormalisedValue(this.checked ? 1.0 : 0.0);
+        freeze.state.sliderDragEnded();
     };
     // box is checked if backend value is greater than or equal to 0.5
     freeze.state.valueChangedEvent.addListener(() => {
@@ -315,11 +408,27 @@ function updateSliderDOMObjectAndSliderState(sliderDOMObject, sliderState, stepV
     sliderDOMObject.max = sliderState.properties.end;
     sliderDOMObject.step = stepValue;
 
+    // wrap every drag (or keyboard adjustment) in a gesture so the backend
+    // records it as a single undo transaction
+    let isDragging = false;
+
     sliderDOMObject.oninput = function () {
+        if (!isDragging) {
+            sliderState.sliderDragStarted();
+            isDragging = true;
+        }
         sliderState.setNormalisedValue(this.value);
         updateValueElement(sliderDOMObject, this.value);
     };
 
+    // "change" fires once the pointer is released or a keyboard step is committed
+    sliderDOMObject.onchange = function () {
+        if (isDragging) {
+            sliderState.sliderDragEnded();
+            isDragging = false;
+        }
+    };
+
     sliderState.valueChangedEvent.addListener(() => {
         sliderDOMObject.value = sliderState.getScaledValue();
         updateValueElement(sliderDOMObject, sliderDOMObject.value);     
@@ -49,6 +49,9 @@ export default class ParticleWave {
 
     // << used in onLevelsChange() in index.js >> 
     animateParticles(levels, count = 0) {
+        // the backend publishes fewer bins when frames are slow; spread them over every particle
+        levels = this.#expandLevels(levels);
+
         if (this.#smoothedLevels.length !== levels.length) {
             for (let i = 0; i < levels.length; i++) {
                 this.#smoothedLevels[i] = levels[i];
@@ -228,6 +231,16 @@ export default class ParticleWave {
     }
 
     // << used in this.animateParticles() >>
+    #expandLevels(levels) {
+        if (levels.length >= ParticleWave.NUM_PARTICLES) { return levels; }
+
+        const expanded = new Array(ParticleWave.NUM_PARTICLES);
+        for (let i = 0; i < ParticleWave.NUM_PARTICLES; i++) {
+            expanded[i] = levels[Math.floor(i * levels.length / ParticleWave.NUM_PARTICLES)];
+        }
+        return expanded;
+    }
+
     #calculateHue(freqPosition) {
         return 0 + (180 * freqPosition);
     }
@@ -0,0 +1,253 @@
+/*
+  ==============================================================================
+
+    Command line batch renderer for 3DVerb.
+
+    Renders every WAV file in a folder through its own ThreeDVerbAudioProcessor
+    (no editor), using a saved plugin state blob from getStateInformation().
+
+    usage:
+        3DVerbBatchRender --input <folder> --output <folder> --state <file>
+                          [--threads <n>] [--block <samples>] [--max-tail <seconds>]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../Common/CommandLine.h"
+
+namespace batch_render
+{
+    struct Settings
+    {
+        juce::File inputDirectory;
+        juce::File outputDirectory;
+        juce::MemoryBlock state;
+        int numThreads{ juce::SystemStats::getNumCpus() };
+        // large blocks keep disk I/O sequential and amortise per-block overhead
+        int blockSize{ 8192 };
+        // freeze mode reports an infinite tail; never render more than this
+        double maxTailSeconds{ 30.0 };
+    };
+
+    class RenderJob : public juce::ThreadPoolJob
+    {
+    public:
+        RenderJob(const juce::File& in, const juce::File& out, const Settings& s)
+            : juce::ThreadPoolJob(in.getFileName()),
+            inputFile(in),
+            outputFile(out),
+            settings(s),
+            // construct on the message thread; apvts starts a timer in its constructor
+            processor(std::make_unique<webview_plugin::ThreeDVerbAudioProcessor>())
+        {
+            formatManager.registerBasicFormats();
+        }
+
+        JobStatus runJob() override
+        {
+            const auto startTicks = juce::Time::getHighResolutionTicks();
+
+            std::unique_ptr<juce::AudioFormatReader> reader{ formatManager.createReaderFor(inputFile) };
+            if (reader == nullptr)
+                return fail("could not open input file");
+
+            const auto sampleRate = reader->sampleRate;
+            const auto blockSize = settings.blockSize;
+            constexpr auto numChannels{ 2 };
+
+            // no editor is ever created, so analysis stays off (no thread, no ring copies)
+            processor->setNonRealtime(true);
+            processor->setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+            processor->setStateInformation(settings.state.getData(), static_cast<int>(settings.state.getSize()));
+            processor->prepareToPlay(sampleRate, blockSize);
+
+            auto tailSeconds = processor->getTailLengthSeconds();
+            if (!std::isfinite(tailSeconds))
+                tailSeconds = settings.maxTailSeconds;
+            tailSeconds = juce::jmin(tailSeconds, settings.maxTailSeconds);
+
+            const auto inputLength = reader->lengthInSamples;
+            const auto totalLength = inputLength + static_cast<juce::int64>(tailSeconds * sampleRate);
+
+            const auto writer = tools::createWavWriter(outputFile, sampleRate, numChannels,
+                juce::jmax(24, static_cast<int>(reader->bitsPerSample)), 1 << 20);
+            if (writer == nullptr)
+                return fail("could not create output file");
+
+            juce::AudioBuffer<float> buffer{ numChannels, blockSize };
+            juce::MidiBuffer midi;
+
+            for (juce::int64 position = 0; position < totalLength; position += blockSize)
+            {
+                if (shouldExit())
+                    return fail("cancelled");
+
+                const auto numSamples = static_cast<int>(juce::jmin<juce::int64>(blockSize, totalLength - position));
+                buffer.clear();
+
+                // past the end of the input only the reverb tail is left to render
+                if (position < inputLength)
+                {
+                    const auto numToRead = static_cast<int>(juce::jmin<juce::int64>(numSamples, inputLength - position));
+                    // a mono reader is copied into both channels
+                    reader->read(&buffer, 0, numToRead, position, true, true);
+                }
+
+                // the processor works on whatever buffer size it receives
+                juce::AudioBuffer<float> view{ buffer.getArrayOfWritePointers(), numChannels, numSamples };
+                processor->processBlock(view, midi);
+
+                if (!writer->writeFromAudioSampleBuffer(view, 0, numSamples))
+                    return fail("write failed");
+            }
+
+            processor->releaseResources();
+
+            secondsRendered = static_cast<double>(totalLength) / sampleRate;
+            secondsElapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+            succeeded = true;
+            return jobHasFinished;
+        }
+
+        const juce::File& getInputFile() const { return inputFile; }
+        bool hasSucceeded() const { return succeeded; }
+        const juce::String& getErrorMessage() const { return errorMessage; }
+        double getSecondsRendered() const { return secondsRendered; }
+        double getSecondsElapsed() const { return secondsElapsed; }
+
+    private:
+        JobStatus fail(const juce::String& message)
+        {
+            errorMessage = message;
+            return jobHasFinished;
+        }
+
+        juce::File inputFile;
+        juce::File outputFile;
+        const Settings& settings;
+
+        juce::AudioFormatManager formatManager;
+        std::unique_ptr<webview_plugin::ThreeDVerbAudioProcessor> processor;
+
+        bool succeeded{ false };
+        juce::String errorMessage;
+        double secondsRendered{ 0.0 };
+        double secondsElapsed{ 0.0 };
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderJob)
+    };
+
+    void printUsage()
+    {
+        std::cout << "usage: 3DVerbBatchRender --input <folder> --output <folder> --state <file>\n"
+                  << "                         [--threads <n>] [--block <samples>] [--max-tail <seconds>]\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace batch_render;
+
+    const tools::CommandLine commandLine{ argc, argv };
+    const auto& args = commandLine.args;
+
+    if (!args.containsOption("--input") || !args.containsOption("--output") || !args.containsOption("--state"))
+    {
+        printUsage();
+        return 1;
+    }
+
+    Settings settings;
+    settings.inputDirectory = commandLine.getFileForOption("--input");
+    settings.outputDirectory = commandLine.getFileForOption("--output");
+
+    if (!settings.inputDirectory.isDirectory())
+    {
+        std::cerr << "input folder does not exist\n";
+        return 1;
+    }
+
+    if (!commandLine.getFileForOption("--state").loadFileAsData(settings.state))
+    {
+        std::cerr << "could not read state file\n";
+        return 1;
+    }
+
+    if (args.containsOption("--threads"))
+        settings.numThreads = juce::jmax(1, args.getValueForOption("--threads").getIntValue());
+    if (args.containsOption("--block"))
+        settings.blockSize = juce::jmax(32, args.getValueForOption("--block").getIntValue());
+    if (args.containsOption("--max-tail"))
+        settings.maxTailSeconds = juce::jmax(0.0, args.getValueForOption("--max-tail").getDoubleValue());
+
+    if (!settings.outputDirectory.createDirectory())
+    {
+        std::cerr << "could not create output folder\n";
+        return 1;
+    }
+
+    auto inputFiles = settings.inputDirectory.findChildFiles(juce::File::findFiles, false, "*.wav;*.WAV");
+    if (inputFiles.isEmpty())
+    {
+        std::cerr << "no WAV files found in " << settings.inputDirectory.getFullPathName() << "\n";
+        return 1;
+    }
+
+    // longest files first: idle workers pick up the short ones at the end,
+    // so no core sits waiting on one long stem queued last
+    std::sort(inputFiles.begin(), inputFiles.end(), [](const juce::File& a, const juce::File& b)
+    {
+        return a.getSize() > b.getSize();
+    });
+
+    std::vector<std::unique_ptr<RenderJob>> jobs;
+    for (const auto& file : inputFiles)
+    {
+        const auto outputFile = settings.outputDirectory.getChildFile(file.getFileNameWithoutExtension() + "_3DVerb.wav");
+        jobs.push_back(std::make_unique<RenderJob>(file, outputFile, settings));
+    }
+
+    std::cout << "rendering " << jobs.size() << " files on " << settings.numThreads << " threads\n";
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    {
+        // every worker pulls the next job from the shared queue as soon as it is free
+        juce::ThreadPool pool{ settings.numThreads };
+        for (auto& job : jobs)
+            pool.addJob(job.get(), false);
+
+        for (auto& job : jobs)
+            pool.waitForJobToFinish(job.get(), -1);
+    }
+    const auto wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    auto totalSecondsRendered{ 0.0 };
+    auto numFailed{ 0 };
+
+    for (const auto& job : jobs)
+    {
+        if (!job->hasSucceeded())
+        {
+            std::cerr << job->getInputFile().getFileName() << ": " << job->getErrorMessage() << "\n";
+            ++numFailed;
+            continue;
+        }
+
+        totalSecondsRendered += job->getSecondsRendered();
+        std::cout << job->getInputFile().getFileName() << ": "
+                  << juce::String(job->getSecondsRendered(), 2) << " s rendered in "
+                  << juce::String(job->getSecondsElapsed(), 2) << " s ("
+                  << juce::String(job->getSecondsRendered() / juce::jmax(1.0e-9, job->getSecondsElapsed()), 1)
+                  << "x realtime per core)\n";
+    }
+
+    const auto aggregate = totalSecondsRendered / juce::jmax(1.0e-9, wallSeconds);
+    std::cout << "total: " << juce::String(totalSecondsRendered, 2) << " s of audio in "
+              << juce::String(wallSeconds, 2) << " s wall clock = "
+              << juce::String(aggregate, 1) << "x realtime ("
+              << juce::String(aggregate / settings.numThreads, 1) << "x per thread)\n";
+
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    Command line scaffolding shared by the 3DVerb tools (BatchRender,
+    Fingerprint), so they parse arguments and write files the same way.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+namespace tools
+{
+    // construct first thing in main()
+    struct CommandLine
+    {
+        CommandLine(int argc, char* argv[]) : args{ argc, argv } {}
+
+        // ArgumentList::getFileForOption() throws on a missing value; resolve the path ourselves
+        juce::File getFileForOption(juce::StringRef option) const
+        {
+            return juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption(option).unquoted());
+        }
+
+        // the processor's apvts needs a message manager
+        juce::ScopedJuceInitialiser_GUI juceInitialiser;
+        juce::ArgumentList args;
+    };
+
+    // replaces file; returns nullptr if it can't be created
+    inline std::unique_ptr<juce::AudioFormatWriter> createWavWriter(const juce::File& file, double sampleRate,
+        int numChannels, int bitsPerSample, int bufferSize = 16384)
+    {
+        file.deleteFile();
+
+        auto stream = std::make_unique<juce::FileOutputStream>(file, static_cast<size_t>(bufferSize));
+        if (stream->failedToOpen())
+            return nullptr;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer{ wav.createWriterFor(
+            stream.get(), sampleRate, static_cast<unsigned int>(numChannels), bitsPerSample, {}, 0) };
+
+        // the writer now owns the stream
+        if (writer != nullptr)
+            stream.release();
+
+        return writer;
+    }
+}
@@ -0,0 +1,572 @@
+/*
+  ==============================================================================
+
+    Output fingerprint regression check for 3DVerb.
+
+    Renders fixed input signals through ThreeDVerbAudioProcessor across a matrix
+    of sample rates, host block sizes and parameter sets, and compares the output,
+    the spectrum levels (what Fifo::levels publishes to the frontend) and the
+    loudness readings with reference renders recorded earlier. The levels and
+    loudness come from the processor's own AnalysisThread, drained synchronously
+    after every block, once for each FFT order.
+
+    usage:
+        3DVerbFingerprint --record <folder> [--filter <text>]
+        3DVerbFingerprint --verify <folder> [--filter <text>]
+
+    Record references with a known-good build, then verify after any DSP change.
+    --verify exits with 1 and prints a diff summary if any case is out of tolerance.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../Source/PluginProcessor.h"
+#include "../../../Source/ParameterIDs.h"
+#include "../../Common/CommandLine.h"
+
+namespace fingerprint
+{
+    enum class Signal { impulse, sweep, noise };
+
+    // what happens halfway through the input
+    enum class Scenario { none, automation, snapshotRecall };
+
+    struct ParameterSet
+    {
+        const char* name;
+        float size;
+        float mix;
+        float width;
+        float damp;
+        float freeze;
+        float gain;
+        bool mono;
+        Scenario scenario;
+        // largest allowed absolute sample difference; 0 == bit-exact
+        float outputTolerance;
+    };
+
+    constexpr std::array<double, 3> sampleRates{ 44100.0, 48000.0, 96000.0 };
+    // below, between and well above the processor's 128 sample sub-block
+    constexpr std::array<int, 3> blockSizes{ 32, 333, 4096 };
+    constexpr std::array<Signal, 3> signals{ Signal::impulse, Signal::sweep, Signal::noise };
+
+    // sets that only go through juce::dsp::Reverb's scalar code must match exactly;
+    // sets that also hit FloatVectorOperations (mono sum, gain ramp, snapshot crossfade) may
+    // differ by a few ULPs between SIMD paths and compilers that fuse multiply-adds
+    constexpr auto simdTolerance{ 1.0e-6f };
+    const std::array<ParameterSet, 7> parameterSets{ {
+        { "default",      0.5f,  0.75f, 0.75f, 0.5f, 0.0f, 1.0f, true,  Scenario::none,           simdTolerance },
+        { "stereo",       0.5f,  0.75f, 0.75f, 0.5f, 0.0f, 1.0f, false, Scenario::none,           0.0f },
+        { "large-wide",   0.95f, 1.0f,  1.0f,  0.1f, 0.0f, 1.0f, false, Scenario::none,           0.0f },
+        { "small-damped", 0.1f,  0.4f,  0.2f,  0.9f, 0.0f, 0.5f, false, Scenario::none,           simdTolerance },
+        { "frozen",       0.5f,  1.0f,  0.75f, 0.5f, 1.0f, 1.0f, false, Scenario::none,           0.0f },
+        { "automated",    0.5f,  0.75f, 0.75f, 0.5f, 0.0f, 1.0f, false, Scenario::automation,     simdTolerance },
+        { "snapshot",     0.5f,  0.75f, 0.75f, 0.5f, 0.0f, 1.0f, false, Scenario::snapshotRecall, simdTolerance }
+    } };
+
+    // spectrum levels are 0..1 over 100 dB; FFT backends (fallback, vDSP, IPP) differ slightly
+    constexpr auto levelsTolerance{ 1.0e-3f };
+    // momentary / short-term LUFS, true peak and output level, all in dB
+    constexpr auto loudnessTolerance{ 0.01f };
+
+    struct AnalysisSettings
+    {
+        int fftOrder;
+        int overlap;
+    };
+
+    // every analyser size, and every overlap once; each case is rendered once per entry
+    constexpr std::array<AnalysisSettings, 3> analysisSettings{ { { 10, 1 }, { 11, 2 }, { 12, 4 } } };
+
+    constexpr auto numChannels{ 2 };
+    constexpr auto inputSeconds{ 0.5 };
+    // input plus some of the tail
+    constexpr auto renderSeconds{ 1.5 };
+    // levels and loudness are read this many times, evenly spread over the render
+    constexpr auto numLevelSnapshots{ 4 };
+    // momentary, short-term, true peak, output level
+    constexpr auto numLoudnessValues{ 4 };
+
+    struct Case
+    {
+        Signal signal;
+        const ParameterSet* parameters;
+        double sampleRate;
+        int blockSize;
+
+        juce::String getName() const
+        {
+            const auto* signalName = signal == Signal::impulse ? "impulse" : signal == Signal::sweep ? "sweep" : "noise";
+            return juce::String(signalName) + "_" + parameters->name + "_"
+                + juce::String(juce::roundToInt(sampleRate)) + "_" + juce::String(blockSize);
+        }
+    };
+
+    struct Fingerprint
+    {
+        juce::AudioBuffer<float> output;
+        // per analysis setting, per snapshot
+        juce::Array<juce::var> levels;
+        juce::Array<juce::var> loudness;
+        // set if rendering went wrong in a way no reference can catch
+        juce::String problem;
+    };
+
+    bool isBitIdentical(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+            return false;
+
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            if (std::memcmp(a.getReadPointer(ch), b.getReadPointer(ch), sizeof(float) * (size_t)a.getNumSamples()) != 0)
+                return false;
+
+        return true;
+    }
+
+    juce::AudioBuffer<float> makeInput(Signal signal, double sampleRate, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer{ numChannels, numSamples };
+        buffer.clear();
+
+        const auto inputLength = juce::jmin(numSamples, static_cast<int>(sampleRate * inputSeconds));
+
+        switch (signal)
+        {
+            // left only, so width and the stereo spread show up
+            case Signal::impulse:
+                buffer.setSample(0, 0, 1.0f);
+                break;
+
+            // exponential sine sweep, 20 Hz to 20 kHz
+            case Signal::sweep:
+            {
+                constexpr auto startHz{ 20.0 };
+                constexpr auto endHz{ 20000.0 };
+                const auto rate = std::log(endHz / startHz);
+
+                for (int i = 0; i < inputLength; ++i)
+                {
+                    const auto t = i / sampleRate;
+                    const auto phase = juce::MathConstants<double>::twoPi * startHz * inputSeconds / rate
+                        * (std::exp(t * rate / inputSeconds) - 1.0);
+                    const auto sample = static_cast<float>(0.5 * std::sin(phase));
+                    buffer.setSample(0, i, sample);
+                    buffer.setSample(1, i, sample);
+                }
+                break;
+            }
+
+            // independent channels; juce::Random is deterministic for a given seed
+            case Signal::noise:
+            {
+                juce::Random random{ 0x3d7e4b };
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < inputLength; ++i)
+                        buffer.setSample(ch, i, 0.25f * (2.0f * random.nextFloat() - 1.0f));
+                break;
+            }
+        }
+
+        return buffer;
+    }
+
+    void setParameter(webview_plugin::ThreeDVerbAudioProcessor& processor, const juce::ParameterID& id, float value)
+    {
+        auto* parameter = processor.apvts.getParameter(id.getParamID());
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    void setParameters(webview_plugin::ThreeDVerbAudioProcessor& processor, const ParameterSet& set)
+    {
+        namespace id = webview_plugin::id;
+
+        setParameter(processor, id::SIZE, set.size);
+        setParameter(processor, id::MIX, set.mix);
+        setParameter(processor, id::WIDTH, set.width);
+        setParameter(processor, id::DAMP, set.damp);
+        setParameter(processor, id::FREEZE, set.freeze);
+        setParameter(processor, id::GAIN, set.gain);
+        setParameter(processor, id::MONO, set.mono ? 1.0f : 0.0f);
+    }
+
+    // main thread only; parameter changes made between processBlock() calls are ramped across
+    // the next block, and analysis runs on this thread, so every render is deterministic for a
+    // given block size. Appends the levels and loudness to fingerprint and returns the output
+    juce::AudioBuffer<float> render(const Case& c, const AnalysisSettings& settings, Fingerprint& fingerprint)
+    {
+        namespace id = webview_plugin::id;
+        using webview_plugin::SnapshotBank;
+
+        webview_plugin::ThreeDVerbAudioProcessor processor;
+        // the processor's own analysis, minus the thread that would make it depend on scheduling
+        processor.setAnalysisThreadEnabled(false);
+        processor.setAnalysisEnabled(true);
+        processor.analysis.setFftOrder(settings.fftOrder);
+        processor.analysis.setFftOverlap(settings.overlap);
+        processor.setNonRealtime(true);
+        processor.setPlayConfigDetails(numChannels, numChannels, c.sampleRate, c.blockSize);
+
+        // snapshot B holds the large-wide set; the render starts on this case's own values and recalls B
+        if (c.parameters->scenario == Scenario::snapshotRecall)
+        {
+            setParameters(processor, parameterSets[2]);
+            processor.storeSnapshot(SnapshotBank::slotB);
+        }
+
+        setParameters(processor, *c.parameters);
+        processor.prepareToPlay(c.sampleRate, c.blockSize);
+
+        const auto numSamples = static_cast<int>(c.sampleRate * renderSeconds);
+        const auto changePosition = static_cast<int>(c.sampleRate * inputSeconds * 0.5);
+        auto hasChanged{ false };
+        auto numSnapshotsTaken{ 0 };
+
+        auto output = makeInput(c.signal, c.sampleRate, numSamples);
+        juce::MidiBuffer midi;
+
+        for (int position = 0; position < numSamples; position += c.blockSize)
+        {
+            if (!hasChanged && position >= changePosition)
+            {
+                hasChanged = true;
+
+                if (c.parameters->scenario == Scenario::automation)
+                {
+                    setParameter(processor, id::SIZE, 0.9f);
+                    setParameter(processor, id::DAMP, 0.2f);
+                    setParameter(processor, id::GAIN, 0.7f);
+                }
+                else if (c.parameters->scenario == Scenario::snapshotRecall)
+                {
+                    processor.recallSnapshot(SnapshotBank::slotB);
+                }
+            }
+
+            const auto blockLength = juce::jmin(c.blockSize, numSamples - position);
+            juce::AudioBuffer<float> view{ output.getArrayOfWritePointers(), numChannels, position, blockLength };
+            processor.processBlock(view, midi);
+            processor.analysis.analysePending();
+
+            // snapshots are further apart than the largest block, so at most one is due per block
+            const auto nextSnapshotPosition = static_cast<int>((juce::int64)numSamples * (numSnapshotsTaken + 1) / numLevelSnapshots);
+            if (position + blockLength >= nextSnapshotPosition)
+            {
+                ++numSnapshotsTaken;
+                fingerprint.levels.addArray(processor.analysis.getSpectrum().levels);
+
+                const auto& loudness = processor.analysis.getLoudnessMeter();
+                fingerprint.loudness.add(loudness.getMomentaryLufs(), loudness.getShortTermLufs(),
+                    loudness.getTruePeakDecibels(), processor.analysis.getOutputLevelDecibels());
+            }
+        }
+
+        processor.releaseResources();
+        jassert(numSnapshotsTaken == numLevelSnapshots);
+
+        return output;
+    }
+
+    Fingerprint render(const Case& c)
+    {
+        Fingerprint fingerprint;
+
+        // analysis must not touch the output: the first render's is kept and the others have to match it
+        for (const auto& settings : analysisSettings)
+        {
+            auto output = render(c, settings, fingerprint);
+
+            if (fingerprint.output.getNumSamples() == 0)
+                fingerprint.output = std::move(output);
+            else if (!isBitIdentical(output, fingerprint.output) && fingerprint.problem.isEmpty())
+                fingerprint.problem = "output changes with the analysis settings (FFT order "
+                    + juce::String(settings.fftOrder) + ", overlap " + juce::String(settings.overlap) + ")";
+        }
+
+        return fingerprint;
+    }
+
+    juce::File getAudioFile(const juce::File& directory, const Case& c) { return directory.getChildFile(c.getName() + ".wav"); }
+    juce::File getLevelsFile(const juce::File& directory, const Case& c) { return directory.getChildFile(c.getName() + ".levels.json"); }
+
+    juce::Result record(const juce::File& directory, const Case& c, const Fingerprint& fingerprint)
+    {
+        if (fingerprint.problem.isNotEmpty())
+            return juce::Result::fail(fingerprint.problem);
+
+        // 32 bit float, so a bit-exact comparison is possible
+        const auto audioFile = getAudioFile(directory, c);
+        const auto writer = tools::createWavWriter(audioFile, c.sampleRate, numChannels, 32);
+        if (writer == nullptr)
+            return juce::Result::fail("could not create " + audioFile.getFullPathName());
+
+        if (!writer->writeFromAudioSampleBuffer(fingerprint.output, 0, fingerprint.output.getNumSamples()))
+            return juce::Result::fail("write failed");
+
+        auto* analysis = new juce::DynamicObject();
+        analysis->setProperty("levels", fingerprint.levels);
+        analysis->setProperty("loudness", fingerprint.loudness);
+
+        if (!getLevelsFile(directory, c).replaceWithText(juce::JSON::toString(juce::var{ analysis }, true)))
+            return juce::Result::fail("could not write levels");
+
+        return juce::Result::ok();
+    }
+
+    struct Difference
+    {
+        juce::String problem;
+        float maxError{ 0.0f };
+        int maxErrorSample{ 0 };
+        int maxErrorChannel{ 0 };
+        double errorRms{ 0.0 };
+        float maxLevelError{ 0.0f };
+        int maxLevelErrorIndex{ 0 };
+        float maxLoudnessError{ 0.0f };
+        int maxLoudnessErrorIndex{ 0 };
+
+        bool isOutOfTolerance(const ParameterSet& set) const
+        {
+            return problem.isNotEmpty() || maxError > set.outputTolerance || maxLevelError > levelsTolerance
+                || maxLoudnessError > loudnessTolerance;
+        }
+    };
+
+    // largest difference between two equally sized arrays of numbers, and where it is
+    void findMaxError(const juce::Array<juce::var>& actual, const juce::Array<juce::var>& expected, float& maxError, int& maxErrorIndex)
+    {
+        for (int i = 0; i < expected.size(); ++i)
+        {
+            const auto error = std::abs(static_cast<float>(actual[i]) - static_cast<float>(expected[i]));
+            if (error > maxError)
+            {
+                maxError = error;
+                maxErrorIndex = i;
+            }
+        }
+    }
+
+    // levels are stored per analysis setting, then per snapshot, then per scope bin
+    juce::String describeLevelIndex(int index)
+    {
+        for (const auto& settings : analysisSettings)
+        {
+            // Fifo's default scope size
+            const auto scopeSize = (1 << settings.fftOrder) / 4;
+            if (index < numLevelSnapshots * scopeSize)
+                return "FFT order " + juce::String(settings.fftOrder) + " overlap " + juce::String(settings.overlap)
+                    + ", snapshot " + juce::String(index / scopeSize) + ", bin " + juce::String(index % scopeSize);
+
+            index -= numLevelSnapshots * scopeSize;
+        }
+
+        return "index " + juce::String(index);
+    }
+
+    juce::String describeLoudnessIndex(int index)
+    {
+        static constexpr std::array<const char*, numLoudnessValues> names{ "momentary LUFS", "short-term LUFS", "true peak", "output level" };
+        const auto& settings = analysisSettings[(size_t)(index / (numLevelSnapshots * numLoudnessValues)) % analysisSettings.size()];
+
+        return juce::String(names[(size_t)(index % numLoudnessValues)]) + " at snapshot " + juce::String(index / numLoudnessValues % numLevelSnapshots)
+            + " (FFT order " + juce::String(settings.fftOrder) + " overlap " + juce::String(settings.overlap) + ")";
+    }
+
+    Difference compare(const juce::File& directory, const Case& c, const Fingerprint& fingerprint, juce::AudioFormatManager& formatManager)
+    {
+        Difference difference;
+
+        if (fingerprint.problem.isNotEmpty())
+        {
+            difference.problem = fingerprint.problem;
+            return difference;
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader{ formatManager.createReaderFor(getAudioFile(directory, c)) };
+        if (reader == nullptr)
+        {
+            difference.problem = "no reference render";
+            return difference;
+        }
+
+        const auto& output = fingerprint.output;
+        const auto numSamples = output.getNumSamples();
+
+        if (reader->lengthInSamples != numSamples || static_cast<int>(reader->numChannels) != numChannels)
+        {
+            difference.problem = "reference has a different length or channel count";
+            return difference;
+        }
+
+        juce::AudioBuffer<float> reference{ numChannels, numSamples };
+        reader->read(&reference, 0, numSamples, 0, true, true);
+
+        auto sumOfSquares{ 0.0 };
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* actual = output.getReadPointer(ch);
+            const auto* expected = reference.getReadPointer(ch);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const auto error = std::abs(actual[i] - expected[i]);
+                sumOfSquares += (double)error * error;
+
+                if (error > difference.maxError)
+                {
+                    difference.maxError = error;
+                    difference.maxErrorSample = i;
+                    difference.maxErrorChannel = ch;
+                }
+            }
+        }
+        difference.errorRms = std::sqrt(sumOfSquares / (numSamples * numChannels));
+
+        const auto reference = juce::JSON::parse(getLevelsFile(directory, c));
+        const auto* levels = reference["levels"].getArray();
+        const auto* loudness = reference["loudness"].getArray();
+        if (levels == nullptr || levels->size() != fingerprint.levels.size()
+            || loudness == nullptr || loudness->size() != fingerprint.loudness.size())
+        {
+            difference.problem = "reference levels or loudness are missing or a different size";
+            return difference;
+        }
+
+        findMaxError(fingerprint.levels, *levels, difference.maxLevelError, difference.maxLevelErrorIndex);
+        findMaxError(fingerprint.loudness, *loudness, difference.maxLoudnessError, difference.maxLoudnessErrorIndex);
+
+        return difference;
+    }
+
+    juce::String toDecibelString(double value)
+    {
+        return value > 0.0 ? juce::String(juce::Decibels::gainToDecibels(value, -400.0), 1) + " dB" : "exact";
+    }
+
+    std::vector<Case> makeCases(const juce::String& filter)
+    {
+        std::vector<Case> cases;
+
+        for (const auto signal : signals)
+            for (const auto& parameters : parameterSets)
+                for (const auto sampleRate : sampleRates)
+                    for (const auto blockSize : blockSizes)
+                    {
+                        Case c{ signal, &parameters, sampleRate, blockSize };
+                        if (filter.isEmpty() || c.getName().contains(filter))
+                            cases.push_back(c);
+                    }
+
+        return cases;
+    }
+
+    void printUsage()
+    {
+        std::cout << "usage: 3DVerbFingerprint --record <folder> [--filter <text>]\n"
+                  << "       3DVerbFingerprint --verify <folder> [--filter <text>]\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace fingerprint;
+
+    const tools::CommandLine commandLine{ argc, argv };
+    const auto& args = commandLine.args;
+
+    const auto isRecording = args.containsOption("--record");
+    if (isRecording == args.containsOption("--verify"))
+    {
+        printUsage();
+        return 1;
+    }
+
+    const auto directory = commandLine.getFileForOption(isRecording ? "--record" : "--verify");
+    const auto cases = makeCases(args.getValueForOption("--filter"));
+
+    if (cases.empty())
+    {
+        std::cerr << "no cases match the filter\n";
+        return 1;
+    }
+
+    if (isRecording)
+    {
+        if (!directory.createDirectory())
+        {
+            std::cerr << "could not create " << directory.getFullPathName() << "\n";
+            return 1;
+        }
+
+        for (const auto& c : cases)
+        {
+            if (const auto result = record(directory, c, render(c)); result.failed())
+            {
+                std::cerr << c.getName() << ": " << result.getErrorMessage() << "\n";
+                return 1;
+            }
+        }
+
+        std::cout << "recorded " << cases.size() << " references in " << directory.getFullPathName() << "\n";
+        return 0;
+    }
+
+    if (!directory.isDirectory())
+    {
+        std::cerr << "reference folder does not exist\n";
+        return 1;
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    auto numFailed{ 0 };
+    auto worstPassingError{ 0.0f };
+    auto worstPassingLevelError{ 0.0f };
+    auto worstPassingLoudnessError{ 0.0f };
+
+    for (const auto& c : cases)
+    {
+        const auto difference = compare(directory, c, render(c), formatManager);
+
+        if (!difference.isOutOfTolerance(*c.parameters))
+        {
+            worstPassingError = juce::jmax(worstPassingError, difference.maxError);
+            worstPassingLevelError = juce::jmax(worstPassingLevelError, difference.maxLevelError);
+            worstPassingLoudnessError = juce::jmax(worstPassingLoudnessError, difference.maxLoudnessError);
+            continue;
+        }
+
+        ++numFailed;
+        std::cout << "FAIL " << c.getName() << "\n";
+
+        if (difference.problem.isNotEmpty())
+        {
+            std::cout << "    " << difference.problem << "\n";
+            continue;
+        }
+
+        const auto tolerance = c.parameters->outputTolerance;
+        std::cout << "    output: max error " << toDecibelString(difference.maxError)
+                  << " (" << difference.maxError << ") at sample " << difference.maxErrorSample
+                  << ", channel " << difference.maxErrorChannel
+                  << "; rms error " << toDecibelString(difference.errorRms)
+                  << "; allowed " << (tolerance > 0.0f ? toDecibelString(tolerance) : juce::String("bit-exact")) << "\n";
+
+        std::cout << "    levels: max error " << difference.maxLevelError
+                  << " at " << describeLevelIndex(difference.maxLevelErrorIndex)
+                  << "; allowed " << levelsTolerance << "\n";
+
+        std::cout << "    loudness: max error " << difference.maxLoudnessError << " dB"
+                  << " in " << describeLoudnessIndex(difference.maxLoudnessErrorIndex)
+                  << "; allowed " << loudnessTolerance << " dB\n";
+    }
+
+    std::cout << (cases.size() - (size_t)numFailed) << " of " << cases.size() << " cases match; worst passing error: output "
+              << toDecibelString(worstPassingError) << ", levels " << worstPassingLevelError
+              << ", loudness " << worstPassingLoudnessError << " dB\n";
+
+    return numFailed == 0 ? 0 : 1;
+}